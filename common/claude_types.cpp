@@ -34,7 +34,23 @@ const char* state_label(Claude_state state) {
   return "-";
 }
 
+QVariantMap Claude_session_status::to_variant_map() const {
+  return {
+    {"session_id", session_id},
+    {"state", to_wire_string(state)},
+    {"tool_name", tool_name},
+    {"wait_reason", wait_reason},
+    {"wait_message", wait_message},
+    {"state_since_ms", state_since_ms}
+  };
+}
+
 QVariantMap Claude_workspace_status::to_variant_map() const {
+  QVariantList session_list;
+  for (const auto& session : sessions) {
+    session_list.append(session.to_variant_map());
+  }
+
   return {
     {"state", to_wire_string(state)},
     {"tool_name", tool_name},
@@ -43,6 +59,7 @@ QVariantMap Claude_workspace_status::to_variant_map() const {
     {"state_since_ms", state_since_ms},
     {"color", state_color_hex(state)},
     {"text_color", state_text_color_hex(state)},
-    {"label", state_label(state)}
+    {"label", state_label(state)},
+    {"sessions", session_list}
   };
 }
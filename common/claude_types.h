@@ -2,6 +2,7 @@
 
 #include <QString>
 #include <QVariantMap>
+#include <QVector>
 
 /// Execution state of a Claude Code session within a workspace.
 enum class Claude_state {
@@ -21,7 +22,21 @@ const char* state_text_color_hex(Claude_state state);
 /// Single-character label for the given state (e.g. "R", "W").
 const char* state_label(Claude_state state);
 
-/// Per-workspace snapshot of Claude Code status.
+/// State of one Claude Code session; a workspace may run several.
+struct Claude_session_status {
+  QString session_id;
+  Claude_state state = Claude_state::IDLE;
+  QString tool_name;
+  QString wait_reason;
+  QString wait_message;
+  qint64 state_since_ms = 0;
+
+  QVariantMap to_variant_map() const;
+};
+
+/// Per-workspace snapshot of Claude Code status: the aggregate of its
+/// sessions (WAITING > WORKING > REQUESTING > IDLE), with tool and wait
+/// details of the session that decides it.
 struct Claude_workspace_status {
   QString workspace_name;
   Claude_state state = Claude_state::NOT_RUNNING;
@@ -29,7 +44,8 @@ struct Claude_workspace_status {
   QString wait_reason;   ///< Why Claude is waiting (only meaningful in WAITING state)
   QString wait_message;  ///< User-facing wait message (only meaningful in WAITING state)
   qint64 state_since_ms = 0;  ///< Epoch millis when current state began
-  QString session_id;
+  QString session_id;         ///< Session deciding the aggregate state
+  QVector< Claude_session_status> sessions;  ///< Per-session breakdown
 
   /// Convert to QVariantMap for QML property access.
   /// State is converted to wire-format string ("idle", "working", etc.).
@@ -14,6 +14,8 @@ struct Kwin_desktop {
 
   /// Convert to QVariantMap for QML property access.
   QVariantMap to_variant_map() const;
+
+  bool operator ==(const Kwin_desktop&) const = default;
 };
 
 /// Parse KWin VirtualDesktop struct (position: uint, id: string, name: string).
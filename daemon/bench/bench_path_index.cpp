@@ -0,0 +1,140 @@
+// bench-path-index: find_workspace_by_path cost with many workspaces and
+// deep working directories. Compares the SQL prefix scan Workspace_db ran
+// before Path_index (on an in-memory SQLite table), the trie alone (cache
+// disabled), and the trie behind its LRU cache with a hook-like working set
+// of repeated cwds.
+// Usage: bench-path-index [workspaces] [lookups]
+
+#include "path_index.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+namespace {
+
+/// Levels below a project directory that Claude sessions work in.
+constexpr int cwd_depth = 12;
+/// Distinct cwds the lookups cycle through, as concurrent sessions would.
+constexpr int working_set = 64;
+
+QString project_dir(int workspace) {
+  // Mixed depths and shared prefixes, like ~/src/<group>/<project>.
+  return QString("/home/user/src/group%1/team%2/project%3")
+    .arg(workspace % 16).arg(workspace % 5).arg(workspace);
+}
+
+QStringList make_cwds(int workspaces) {
+  QStringList cwds;
+  for (int i = 0; i < working_set; ++i) {
+    auto cwd = project_dir((i * 7919) % workspaces);
+    for (int level = 0; level < cwd_depth; ++level) {
+      cwd += QString("/dir%1").arg((i + level) % 10);
+    }
+    cwds.append(cwd);
+  }
+  return cwds;
+}
+
+/// Mean ns per lookup of @p lookups calls of @p find over @p cwds.
+double measure(int lookups, const QStringList& cwds, const std::function< QString(const QString&)>& find) {
+  int found = 0;
+  QElapsedTimer elapsed;
+  elapsed.start();
+  for (int i = 0; i < lookups; ++i) {
+    found += find(cwds.at(i % cwds.size())).isEmpty() ? 0 : 1;
+  }
+  auto ns = elapsed.nsecsElapsed();
+  if (found != lookups) {
+    std::fprintf(stderr, "warning: %d of %d lookups found no workspace\n", lookups - found, lookups);
+  }
+  return static_cast< double>(ns) / lookups;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  auto workspaces = argc > 1 ? std::atoi(argv[1]) : 1000;
+  auto lookups = argc > 2 ? std::atoi(argv[2]) : 100000;
+  if (workspaces <= 0 || lookups <= 0) {
+    std::fprintf(stderr, "usage: %s [workspaces] [lookups]\n", argv[0]);
+    return 1;
+  }
+
+  auto cwds = make_cwds(workspaces);
+
+  Path_index uncached(0);
+  Path_index cached;
+  for (int i = 0; i < workspaces; ++i) {
+    uncached.insert(project_dir(i), QString("ws%1").arg(i));
+    cached.insert(project_dir(i), QString("ws%1").arg(i));
+  }
+
+  double scan_ns = 0;
+  {
+    auto db = QSqlDatabase::addDatabase("QSQLITE", "bench");
+    db.setDatabaseName(":memory:");
+    QSqlQuery query(db);
+    if (!db.open() || !query.exec("CREATE TABLE workspace (name TEXT PRIMARY KEY, project_dir TEXT)")) {
+      std::fprintf(stderr, "sqlite: %s\n", qPrintable(db.lastError().text()));
+      return 1;
+    }
+    db.transaction();
+    query.prepare("INSERT INTO workspace (name, project_dir) VALUES (?, ?)");
+    for (int i = 0; i < workspaces; ++i) {
+      query.bindValue(0, QString("ws%1").arg(i));
+      query.bindValue(1, project_dir(i));
+      query.exec();
+    }
+    db.commit();
+
+    // The query find_workspace_by_path ran per hook call, prepared once
+    // here so only the scan itself is measured.
+    query.prepare(
+      "SELECT name FROM workspace"
+      " WHERE project_dir IS NOT NULL"
+      "   AND project_dir != ''"
+      "   AND (? = project_dir"
+      "     OR SUBSTR(?, 1, LENGTH(project_dir) + 1) = project_dir || '/')"
+      " ORDER BY LENGTH(project_dir) DESC"
+      " LIMIT 1"
+    );
+    // The scan is slow; fewer lookups keep the run short.
+    scan_ns = measure(std::max(lookups / 100, 1), cwds, [&query](const QString& path) {
+      query.bindValue(0, path);
+      query.bindValue(1, path);
+      QString name;
+      if (query.exec() && query.next()) {
+        name = query.value(0).toString();
+      }
+      query.finish();
+      return name;
+    });
+    query = QSqlQuery();
+    db.close();
+  }
+  QSqlDatabase::removeDatabase("bench");
+
+  auto trie_ns = measure(lookups, cwds, [&uncached](const QString& path) {
+    return uncached.find(path);
+  });
+  auto cached_ns = measure(lookups, cwds, [&cached](const QString& path) {
+    return cached.find(path);
+  });
+
+  std::printf("%d workspaces, cwd depth %d below the project, %d distinct cwds\n",
+    workspaces, cwd_depth, working_set);
+  std::printf("  sql scan:       %10.2f us/lookup\n", scan_ns / 1000);
+  std::printf("  trie:           %10.2f us/lookup (%.0fx)\n", trie_ns / 1000, scan_ns / trie_ns);
+  std::printf("  trie + lru:     %10.2f us/lookup (%.0fx)\n", cached_ns / 1000, scan_ns / cached_ns);
+  return 0;
+}
@@ -0,0 +1,205 @@
+// bench-statement-registry: per-call cost of the hot Workspace_db statements,
+// prepared on every call (as Workspace_db did before Statement_registry) and
+// acquired from a Statement_registry that compiled them once.
+// Runs on a scratch database in a temporary directory. Writes of each run
+// share one transaction, so commit I/O does not drown the parse cost.
+// Usage: bench-statement-registry [calls]
+
+#include "statement_registry.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+namespace {
+
+enum class Bench_statement {
+  ENSURE_WORKSPACE,
+  SET_CLAUDE_STATE,
+  CLAUDE_STATUS,
+  ACTIVE_DESKTOP_NAME_AT
+};
+
+constexpr int workspace_count = 50;
+
+struct Bench_case {
+  Bench_statement id;
+  const char* method;
+  const char* sql;
+  std::function< void(QSqlQuery& query, int call)> bind;
+  bool reads;
+};
+
+QString workspace_name(int call) {
+  return QString("workspace-%1").arg(call % workspace_count);
+}
+
+const std::vector< Bench_case>& bench_cases() {
+  static const std::vector< Bench_case> cases = {
+    {
+      Bench_statement::ENSURE_WORKSPACE, "ensure_workspace_exists",
+      "INSERT OR IGNORE INTO workspace (name) VALUES (?)",
+      [](QSqlQuery& query, int call) {
+        query.bindValue(0, workspace_name(call));
+      },
+      false
+    },
+    {
+      Bench_statement::SET_CLAUDE_STATE, "set_claude_state",
+      "INSERT INTO claude_session (workspace_name, state, tool_name, wait_reason, wait_message, state_since_ms)"
+      " VALUES (?, ?, ?, ?, ?, ?)"
+      " ON CONFLICT(workspace_name) DO UPDATE SET"
+      "   state = excluded.state,"
+      "   tool_name = excluded.tool_name,"
+      "   wait_reason = excluded.wait_reason,"
+      "   wait_message = excluded.wait_message,"
+      "   state_since_ms = excluded.state_since_ms",
+      [](QSqlQuery& query, int call) {
+        query.bindValue(0, workspace_name(call));
+        query.bindValue(1, call % 2 == 0 ? "working" : "idle");
+        query.bindValue(2, call % 2 == 0 ? QVariant("Bash") : QVariant());
+        query.bindValue(3, QVariant());
+        query.bindValue(4, QVariant());
+        query.bindValue(5, static_cast< qint64>(call));
+      },
+      false
+    },
+    {
+      Bench_statement::CLAUDE_STATUS, "claude_status",
+      "SELECT workspace_name, session_id, state, tool_name,"
+      " wait_reason, wait_message, state_since_ms"
+      " FROM claude_session"
+      " WHERE workspace_name = ?",
+      [](QSqlQuery& query, int call) {
+        query.bindValue(0, workspace_name(call));
+      },
+      true
+    },
+    {
+      Bench_statement::ACTIVE_DESKTOP_NAME_AT, "active_desktop_name_at",
+      "SELECT name FROM workspace"
+      " WHERE is_active = 1"
+      " ORDER BY COALESCE(sort_order, desktop_index)"
+      " LIMIT 1 OFFSET ?",
+      [](QSqlQuery& query, int call) {
+        query.bindValue(0, call % 10);
+      },
+      true
+    }
+  };
+  return cases;
+}
+
+bool create_schema(QSqlDatabase& db) {
+  QSqlQuery query(db);
+  if (!query.exec("PRAGMA journal_mode=WAL")
+    || !query.exec(
+      "CREATE TABLE workspace ("
+      "  name TEXT PRIMARY KEY,"
+      "  project_dir TEXT,"
+      "  is_active INTEGER NOT NULL DEFAULT 0,"
+      "  desktop_index INTEGER,"
+      "  sort_order INTEGER"
+      ")")
+    || !query.exec(
+      "CREATE TABLE claude_session ("
+      "  workspace_name TEXT PRIMARY KEY REFERENCES workspace(name),"
+      "  session_id TEXT,"
+      "  state TEXT NOT NULL DEFAULT 'not_running',"
+      "  tool_name TEXT,"
+      "  wait_reason TEXT,"
+      "  wait_message TEXT,"
+      "  state_since_ms INTEGER NOT NULL DEFAULT 0"
+      ")"))
+  {
+    std::fprintf(stderr, "schema: %s\n", qPrintable(query.lastError().text()));
+    return false;
+  }
+
+  db.transaction();
+  query.prepare("INSERT INTO workspace (name, is_active, desktop_index) VALUES (?, ?, ?)");
+  for (int i = 0; i < workspace_count; ++i) {
+    query.bindValue(0, workspace_name(i));
+    query.bindValue(1, i < 10 ? 1 : 0);
+    query.bindValue(2, i < 10 ? QVariant(i) : QVariant());
+    query.exec();
+  }
+  return db.commit();
+}
+
+void run_statement(QSqlQuery& query, const Bench_case& bench, int call) {
+  bench.bind(query, call);
+  if (!query.exec()) {
+    std::fprintf(stderr, "%s: %s\n", bench.method, qPrintable(query.lastError().text()));
+    return;
+  }
+  if (bench.reads) {
+    query.next();
+  }
+}
+
+/// Mean ns per call of @p calls runs of @p call_once.
+double measure(QSqlDatabase& db, int calls, const std::function< void(int call)>& call_once) {
+  db.transaction();
+  QElapsedTimer elapsed;
+  elapsed.start();
+  for (int call = 0; call < calls; ++call) {
+    call_once(call);
+  }
+  auto ns = elapsed.nsecsElapsed();
+  db.commit();
+  return static_cast< double>(ns) / calls;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  auto calls = argc > 1 ? std::atoi(argv[1]) : 10000;
+  if (calls <= 0) {
+    std::fprintf(stderr, "usage: %s [calls]\n", argv[0]);
+    return 1;
+  }
+
+  QTemporaryDir dir;
+  {
+    auto db = QSqlDatabase::addDatabase("QSQLITE", "bench");
+    db.setDatabaseName(dir.filePath("bench.db"));
+    if (!db.open() || !create_schema(db)) {
+      return 1;
+    }
+
+    Statement_registry< Bench_statement> registry;
+    for (const auto& bench : bench_cases()) {
+      registry.prepare(db, bench.id, QString::fromLatin1(bench.sql));
+    }
+
+    std::printf("%d calls per method\n", calls);
+    std::printf("%-24s %14s %14s %8s\n", "method", "prepare/call", "registry", "speedup");
+    for (const auto& bench : bench_cases()) {
+      auto before_ns = measure(db, calls, [&db, &bench](int call) {
+        QSqlQuery query(db);
+        query.prepare(QString::fromLatin1(bench.sql));
+        run_statement(query, bench, call);
+      });
+      auto after_ns = measure(db, calls, [&registry, &bench](int call) {
+        auto query = registry.acquire(bench.id);
+        run_statement(*query, bench, call);
+      });
+      std::printf("%-24s %11.2f us %11.2f us %7.1fx\n", bench.method,
+        before_ns / 1000, after_ns / 1000, after_ns > 0 ? before_ns / after_ns : 0.0);
+    }
+
+    registry.clear();
+    db.close();
+  }
+  QSqlDatabase::removeDatabase("bench");
+  return 0;
+}
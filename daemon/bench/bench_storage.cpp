@@ -0,0 +1,195 @@
+// bench-storage: the Claude tracker and tab pipeline against both storage
+// backends, Memory_storage (WORKSPACE_STORAGE=memory) and Workspace_db on
+// a scratch database in a temporary directory. The difference between the
+// two is what SQLite persistence costs the GUI thread; "flush" is the wait
+// until the writer thread has made everything durable.
+// Claude events carry no client time, so they apply at once and the
+// reorder window does not hold them.
+// Usage: bench-storage [workspaces] [events] [tab_rounds]
+
+#include "claude_status_tracker.h"
+#include "memory_storage.h"
+#include "workspace_db.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+
+namespace {
+
+constexpr int batch_size = 1000;
+constexpr int tabs_per_workspace = 20;
+
+struct Bench_options {
+  int workspaces;
+  int events;
+  int tab_rounds;
+};
+
+struct Bench_result {
+  double event_ns = 0;          ///< per Claude event, batched
+  double event_flush_ms = 0;
+  double set_tabs_ns = 0;       ///< per call with one URL changed
+  double tabs_flush_ms = 0;
+  double unchanged_tabs_ns = 0; ///< per call with the stored list
+  double get_tabs_ns = 0;
+};
+
+QString workspace_name(int workspace) {
+  return QString("ws%1").arg(workspace);
+}
+
+/// Event @p n of a session's prompt cycle, after its SessionStart.
+Claude_reported_event cycle_event(int workspace, int n) {
+  auto session = QString("session-%1").arg(workspace);
+  switch (n % 4) {
+    case 0:  return {workspace_name(workspace), Claude_event::PROMPT_SUBMIT, {session}};
+    case 1:  return {workspace_name(workspace), Claude_event::WORKING, {QString("Tool%1").arg(n % 7), session}};
+    case 2:  return {workspace_name(workspace), Claude_event::POST_TOOL, {session}};
+    default: return {workspace_name(workspace), Claude_event::STOP, {session}};
+  }
+}
+
+QStringList tab_urls(int workspace, int round) {
+  QStringList urls;
+  for (int i = 0; i < tabs_per_workspace; ++i) {
+    // Each round replaces one tab, as a browser session drifts.
+    auto version = i == round % tabs_per_workspace ? round : 0;
+    urls.append(QString("https://example.org/ws%1/page%2?v=%3").arg(workspace).arg(i).arg(version));
+  }
+  return urls;
+}
+
+/// Elapsed ns of @p run.
+qint64 time_ns(const std::function< void()>& run) {
+  QElapsedTimer elapsed;
+  elapsed.start();
+  run();
+  return elapsed.nsecsElapsed();
+}
+
+Bench_result run(Workspace_storage& storage, const Bench_options& options) {
+  Bench_result result;
+  for (int i = 0; i < options.workspaces; ++i) {
+    storage.create_workspace(workspace_name(i), QString("/home/user/src/project%1").arg(i));
+  }
+  storage.flush();
+
+  {
+    Claude_status_tracker tracker(storage);
+
+    QVector< Claude_reported_event> starts;
+    for (int i = 0; i < options.workspaces; ++i) {
+      starts.append({workspace_name(i), Claude_event::SESSION_START, {QString("session-%1").arg(i)}});
+    }
+    tracker.process_events(starts);
+    storage.flush();
+
+    // Round-robin over the workspaces, so each batch touches many of them.
+    QVector< QVector< Claude_reported_event>> batches;
+    QVector< Claude_reported_event> batch;
+    for (int n = 0; n < options.events; ++n) {
+      batch.append(cycle_event(n % options.workspaces, n / options.workspaces));
+      if (batch.size() == batch_size || n + 1 == options.events) {
+        batches.append(batch);
+        batch.clear();
+      }
+    }
+
+    auto ns = time_ns([&] {
+      for (const auto& events : batches) {
+        tracker.process_events(events);
+      }
+    });
+    result.event_ns = static_cast< double>(ns) / options.events;
+    result.event_flush_ms = time_ns([&] { storage.flush(); }) / 1e6;
+  }
+
+  auto set_calls = options.workspaces * options.tab_rounds;
+  auto ns = time_ns([&] {
+    for (int round = 1; round <= options.tab_rounds; ++round) {
+      for (int i = 0; i < options.workspaces; ++i) {
+        storage.set_tabs(workspace_name(i), tab_urls(i, round));
+      }
+    }
+  });
+  result.set_tabs_ns = static_cast< double>(ns) / set_calls;
+  result.tabs_flush_ms = time_ns([&] { storage.flush(); }) / 1e6;
+
+  // The lists are built outside the timing, like Tab_tracker's poll would.
+  QVector< QStringList> current;
+  for (int i = 0; i < options.workspaces; ++i) {
+    current.append(tab_urls(i, options.tab_rounds));
+  }
+  ns = time_ns([&] {
+    for (int i = 0; i < options.workspaces; ++i) {
+      storage.set_tabs(workspace_name(i), current.at(i));
+    }
+  });
+  result.unchanged_tabs_ns = static_cast< double>(ns) / options.workspaces;
+
+  int read = 0;
+  ns = time_ns([&] {
+    for (int i = 0; i < options.workspaces; ++i) {
+      read += storage.get_tabs(workspace_name(i)).size();
+    }
+  });
+  result.get_tabs_ns = static_cast< double>(ns) / options.workspaces;
+  if (read != options.workspaces * tabs_per_workspace) {
+    std::fprintf(stderr, "warning: read %d tabs, expected %d\n", read, options.workspaces * tabs_per_workspace);
+  }
+  return result;
+}
+
+void print_row(const char* label, double memory, double sqlite, const char* unit) {
+  std::printf("  %-22s %12.2f %12.2f %-8s %7.1fx\n", label, memory, sqlite, unit,
+    memory > 0 ? sqlite / memory : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  // Per-event state change logging would dominate the measurement.
+  QLoggingCategory::setFilterRules("*.info=false");
+
+  Bench_options options{
+    argc > 1 ? std::atoi(argv[1]) : 1000,
+    argc > 2 ? std::atoi(argv[2]) : 100000,
+    argc > 3 ? std::atoi(argv[3]) : 10
+  };
+  if (options.workspaces <= 0 || options.events <= 0 || options.tab_rounds <= 0) {
+    std::fprintf(stderr, "usage: %s [workspaces] [events] [tab_rounds]\n", argv[0]);
+    return 1;
+  }
+
+  Bench_result memory;
+  {
+    Memory_storage storage;
+    memory = run(storage, options);
+  }
+
+  Bench_result sqlite;
+  QTemporaryDir dir;
+  {
+    Workspace_db storage(dir.filePath("workspace.db"));
+    sqlite = run(storage, options);
+  }
+
+  std::printf("%d workspaces, %d Claude events in batches of %d, %d tabs x %d rounds\n",
+    options.workspaces, options.events, batch_size, tabs_per_workspace, options.tab_rounds);
+  std::printf("  %-22s %12s %12s %-8s %8s\n", "", "memory", "sqlite", "", "sqlite/");
+  print_row("claude event", memory.event_ns / 1000, sqlite.event_ns / 1000, "us");
+  print_row("claude flush", memory.event_flush_ms, sqlite.event_flush_ms, "ms");
+  print_row("set_tabs (changed)", memory.set_tabs_ns / 1000, sqlite.set_tabs_ns / 1000, "us");
+  print_row("set_tabs flush", memory.tabs_flush_ms, sqlite.tabs_flush_ms, "ms");
+  print_row("set_tabs (unchanged)", memory.unchanged_tabs_ns / 1000, sqlite.unchanged_tabs_ns / 1000, "us");
+  print_row("get_tabs", memory.get_tabs_ns / 1000, sqlite.get_tabs_ns / 1000, "us");
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include "claude_event_frame.h"
+
+#include <magic_enum.hpp>
+
+#include <algorithm>
+
+namespace {
+
+void append_field(std::string& out, std::string_view field) {
+  if (field.size() > Claude_event_frame::max_field_size) {
+    field = field.substr(0, Claude_event_frame::max_field_size);
+    // Do not leave a partial UTF-8 sequence behind.
+    size_t lead = field.size();
+    while (lead > 0 && (static_cast< unsigned char>(field[lead - 1]) & 0xC0) == 0x80) {
+      --lead;
+    }
+    if (lead > 0) {
+      auto byte = static_cast< unsigned char>(field[lead - 1]);
+      size_t length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+      if (field.size() - (lead - 1) < length) {
+        field = field.substr(0, lead - 1);
+      }
+    }
+  }
+  out.push_back(static_cast< char>(field.size() & 0xFF));
+  out.push_back(static_cast< char>(field.size() >> 8));
+  out.append(field);
+}
+
+std::optional< std::string_view> read_field(std::string_view& data) {
+  if (data.size() < 2) {
+    return std::nullopt;
+  }
+  auto size = static_cast< size_t>(static_cast< unsigned char>(data[0]))
+    | static_cast< size_t>(static_cast< unsigned char>(data[1])) << 8;
+  data.remove_prefix(2);
+  if (data.size() < size) {
+    return std::nullopt;
+  }
+  auto field = data.substr(0, size);
+  data.remove_prefix(size);
+  return field;
+}
+
+} // namespace
+
+std::string encode_claude_event_frame(
+  Claude_event event,
+  bool target_is_path,
+  std::string_view target,
+  const std::vector< std::string>& args,
+  int64_t client_time_ms
+) {
+  auto arg_count = std::min(args.size(), Claude_event_frame::max_args);
+  unsigned char flags = 0;
+  if (target_is_path) {
+    flags |= Claude_event_frame::flag_target_is_path;
+  }
+  if (client_time_ms != 0) {
+    flags |= Claude_event_frame::flag_has_client_time;
+  }
+
+  std::string out;
+  out.reserve(4 + 8 + 2 + target.size() + arg_count * 64);
+  out.push_back(static_cast< char>(Claude_event_frame::version));
+  out.push_back(static_cast< char>(event));
+  out.push_back(static_cast< char>(flags));
+  out.push_back(static_cast< char>(arg_count));
+  if (client_time_ms != 0) {
+    auto value = static_cast< uint64_t>(client_time_ms);
+    for (int i = 0; i < 8; ++i) {
+      out.push_back(static_cast< char>((value >> (8 * i)) & 0xFF));
+    }
+  }
+
+  append_field(out, target);
+  for (size_t i = 0; i < arg_count; ++i) {
+    append_field(out, args[i]);
+  }
+  return out;
+}
+
+std::optional< Claude_event_frame> decode_claude_event_frame(std::string_view data) {
+  if (data.size() < 4 || static_cast< unsigned char>(data[0]) != Claude_event_frame::version) {
+    return std::nullopt;
+  }
+
+  auto event = magic_enum::enum_cast< Claude_event>(static_cast< unsigned char>(data[1]));
+  auto flags = static_cast< unsigned char>(data[2]);
+  auto arg_count = static_cast< size_t>(static_cast< unsigned char>(data[3]));
+  if (!event || arg_count > Claude_event_frame::max_args) {
+    return std::nullopt;
+  }
+  data.remove_prefix(4);
+
+  uint64_t client_time = 0;
+  if (flags & Claude_event_frame::flag_has_client_time) {
+    if (data.size() < 8) {
+      return std::nullopt;
+    }
+    for (int i = 0; i < 8; ++i) {
+      client_time |= static_cast< uint64_t>(static_cast< unsigned char>(data[i])) << (8 * i);
+    }
+    data.remove_prefix(8);
+  }
+
+  auto target = read_field(data);
+  if (!target) {
+    return std::nullopt;
+  }
+
+  Claude_event_frame frame{
+    .event = *event,
+    .target_is_path = (flags & Claude_event_frame::flag_target_is_path) != 0,
+    .client_time_ms = static_cast< int64_t>(client_time),
+    .target = *target,
+    .args = {}
+  };
+  frame.args.reserve(arg_count);
+  for (size_t i = 0; i < arg_count; ++i) {
+    auto arg = read_field(data);
+    if (!arg) {
+      return std::nullopt;
+    }
+    frame.args.push_back(*arg);
+  }
+
+  if (!data.empty()) {
+    return std::nullopt;
+  }
+  return frame;
+}
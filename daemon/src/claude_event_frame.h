@@ -0,0 +1,49 @@
+#pragma once
+
+// No Qt here: shared with the claude-status-hook client.
+
+#include "claude_event_types.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Datagram socket in $XDG_RUNTIME_DIR on which the daemon takes Claude events.
+constexpr const char* claude_event_socket_name = "workspace-menu-claude.sock";
+
+/// One Claude event as carried in a single datagram:
+///   u8 version, u8 event, u8 flags, u8 arg count,
+///   with flag_has_client_time an i64 little-endian client time,
+///   then target and each arg as u16 little-endian length + UTF-8 bytes.
+/// Decoded views point into the datagram buffer.
+struct Claude_event_frame {
+  static constexpr unsigned char version = 1;
+  static constexpr unsigned char flag_target_is_path = 1 << 0;
+  static constexpr unsigned char flag_has_client_time = 1 << 1;
+  static constexpr size_t max_args = 8;
+  static constexpr size_t max_field_size = 4096;
+  static constexpr size_t max_size = 4 + 8 + (max_args + 1) * (2 + max_field_size);
+
+  Claude_event event;
+  /// Target is a cwd for the daemon to resolve, otherwise a workspace name.
+  bool target_is_path = false;
+  /// When the client saw the event (epoch ms), 0 if not sent.
+  int64_t client_time_ms = 0;
+  std::string_view target;
+  std::vector< std::string_view> args;
+};
+
+/// Fields longer than max_field_size are cut at a UTF-8 character boundary;
+/// args beyond max_args are dropped. @p client_time_ms 0 sends no time.
+std::string encode_claude_event_frame(
+  Claude_event event,
+  bool target_is_path,
+  std::string_view target,
+  const std::vector< std::string>& args,
+  int64_t client_time_ms = 0
+);
+
+/// @return nullopt for a malformed frame, an unknown version or event.
+std::optional< Claude_event_frame> decode_claude_event_frame(std::string_view data);
@@ -0,0 +1,188 @@
+#include "claude_event_reorder.h"
+#include "enum_strings.h"
+#include "journal_log.h"
+
+#include <algorithm>
+
+Claude_event_reorder::Claude_event_reorder(std::chrono::milliseconds window, Apply apply)
+  : _window(window)
+  , _apply(std::move(apply))
+{
+  _clock.start();
+  _next_idle_check_ms = std::chrono::duration_cast< std::chrono::milliseconds>(_idle_session_ttl).count();
+  _release_timer.setSingleShot(true);
+  _release_timer.setTimerType(Qt::PreciseTimer);
+  QObject::connect(&_release_timer, &QTimer::timeout, [this]() {
+    on_release_timer();
+  });
+}
+
+bool Claude_event_reorder::submit(const Claude_reported_event& event) {
+  if (event.client_ts_ms <= 0) {
+    _apply(event);
+    return true;
+  }
+
+  Session_key key{event.workspace, event.args.value(claude_event_session_arg(event.event))};
+  auto& queue = _sessions[key];
+  queue.last_event_ms = _clock.elapsed();
+  Order order{event.client_ts_ms, lifecycle_rank(event.event)};
+  if (order < queue.last_applied) {
+    qCWarning(logClaude, "'%s' session %s: dropped stale %s event, %lld ms behind",
+      qPrintable(key.first), qPrintable(key.second),
+      qPrintable(to_wire_string(event.event)),
+      static_cast< long long>(queue.last_applied.first - event.client_ts_ms));
+    return false;
+  }
+
+  Held_event held{order, _next_seq++, event};
+  auto position = std::upper_bound(queue.held.begin(), queue.held.end(), held,
+    [](const Held_event& a, const Held_event& b) {
+      return std::tie(a.order, a.seq) < std::tie(b.order, b.seq);
+    });
+  queue.held.insert(position, std::move(held));
+
+  if (blocks_on_user(event)) {
+    // An earlier-stamped event arriving after this one is dropped as stale;
+    // the WAITING state it would have preceded is already shown.
+    release_through(key, _next_seq - 1);
+  }
+  else {
+    _releases.emplace_back(queue.last_event_ms + _window.count(), key, _next_seq - 1);
+  }
+  if (_releases.size() == 1 || !_release_timer.isActive()) {
+    arm_release_timer();
+  }
+  return true;
+}
+
+void Claude_event_reorder::flush() {
+  _releases.clear();
+  _release_timer.stop();
+  for (auto it = _sessions.begin(); it != _sessions.end(); ++it) {
+    if (!it->held.empty()) {
+      apply_held(it.key(), *it, std::exchange(it->held, {}));
+    }
+  }
+  arm_release_timer();
+}
+
+void Claude_event_reorder::on_release_timer() {
+  auto now = _clock.elapsed();
+  while (!_releases.empty() && std::get< 0>(_releases.front()) <= now) {
+    auto [release_ms, key, seq] = std::move(_releases.front());
+    _releases.pop_front();
+    release_through(key, seq);
+  }
+  forget_ended_sessions(now);
+  if (now >= _next_idle_check_ms) {
+    forget_idle_sessions(now);
+    _next_idle_check_ms = now + std::chrono::duration_cast< std::chrono::milliseconds>(_idle_session_ttl).count();
+  }
+  arm_release_timer();
+}
+
+void Claude_event_reorder::release_through(const Session_key& key, quint64 seq) {
+  auto it = _sessions.find(key);
+  if (it == _sessions.end()) {
+    return;
+  }
+
+  auto& held = it->held;
+  auto last = std::find_if(held.begin(), held.end(), [seq](const Held_event& e) { return e.seq == seq; });
+  if (last == held.end()) {
+    // Already applied along with a later-stamped event.
+    return;
+  }
+
+  std::vector< Held_event> due(std::make_move_iterator(held.begin()), std::make_move_iterator(last + 1));
+  held.erase(held.begin(), last + 1);
+  apply_held(key, *it, std::move(due));
+}
+
+void Claude_event_reorder::apply_held(
+  const Session_key& key, Session_queue& queue, std::vector< Held_event> due
+) {
+  for (const auto& held : due) {
+    queue.last_applied = held.order;
+    if (held.event.event == Claude_event::SESSION_END) {
+      queue.ended_at_ms = _clock.elapsed();
+      _ended.emplace_back(queue.ended_at_ms, key);
+    }
+    else if (held.event.event == Claude_event::SESSION_START) {
+      queue.ended_at_ms = -1;
+    }
+  }
+
+  // Bookkeeping first: _apply may not touch this queue again.
+  for (const auto& held : due) {
+    _apply(held.event);
+  }
+}
+
+void Claude_event_reorder::forget_ended_sessions(qint64 now_ms) {
+  auto ttl_ms = std::chrono::duration_cast< std::chrono::milliseconds>(_ended_session_ttl).count();
+  while (!_ended.empty() && _ended.front().first + ttl_ms <= now_ms) {
+    auto [ended_ms, key] = std::move(_ended.front());
+    _ended.pop_front();
+
+    // Skip sessions restarted, or ended again later, since this entry.
+    auto it = _sessions.find(key);
+    if (it != _sessions.end() && it->ended_at_ms == ended_ms && it->held.empty()) {
+      _sessions.erase(it);
+    }
+  }
+}
+
+void Claude_event_reorder::forget_idle_sessions(qint64 now_ms) {
+  auto ttl_ms = std::chrono::duration_cast< std::chrono::milliseconds>(_idle_session_ttl).count();
+  for (auto it = _sessions.begin(); it != _sessions.end();) {
+    // Ended sessions leave through forget_ended_sessions().
+    if (it->held.empty() && it->ended_at_ms < 0 && it->last_event_ms + ttl_ms <= now_ms) {
+      it = _sessions.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+void Claude_event_reorder::arm_release_timer() {
+  qint64 next_ms = -1;
+  if (!_releases.empty()) {
+    next_ms = std::get< 0>(_releases.front());
+  }
+  else if (!_ended.empty()) {
+    next_ms = _ended.front().first
+      + std::chrono::duration_cast< std::chrono::milliseconds>(_ended_session_ttl).count();
+  }
+  if (!_sessions.isEmpty() && (next_ms < 0 || _next_idle_check_ms < next_ms)) {
+    next_ms = _next_idle_check_ms;
+  }
+
+  if (next_ms >= 0) {
+    auto delay_ms = next_ms - _clock.elapsed();
+    _release_timer.start(std::chrono::milliseconds(std::max< qint64>(delay_ms, 0)));
+  }
+}
+
+bool Claude_event_reorder::blocks_on_user(const Claude_reported_event& event) {
+  if (event.event != Claude_event::NOTIFICATION) {
+    return false;
+  }
+  auto type = from_wire_string< Claude_notification>(event.args.value(0));
+  return type == Claude_notification::PERMISSION_PROMPT || type == Claude_notification::ELICITATION_DIALOG;
+}
+
+int Claude_event_reorder::lifecycle_rank(Claude_event event) {
+  switch (event) {
+    case Claude_event::SESSION_START:  return 0;
+    case Claude_event::PROMPT_SUBMIT:  return 1;
+    case Claude_event::WORKING:        return 2;
+    case Claude_event::NOTIFICATION:   return 3;
+    case Claude_event::POST_TOOL:      return 4;
+    case Claude_event::STOP:           return 5;
+    case Claude_event::SESSION_END:    return 6;
+  }
+  return 0;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "claude_event_types.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/// One reported Claude event, as passed to Claude_status_tracker.
+struct Claude_reported_event {
+  QString workspace;
+  Claude_event event;
+  QStringList args;
+  qint64 client_ts_ms = 0;  ///< When the client saw the event (epoch ms), 0 if unknown
+};
+
+/// Applies each session's timestamped events in client time order. Async
+/// hooks run concurrently, so a PostToolUse can arrive before its
+/// PreToolUse. Each event is held for the window after its arrival; when
+/// the hold ends it is applied together with every held event of its
+/// session stamped earlier, which arrived later but must go first.
+/// An event stamped before the last one applied for its session is stale
+/// and dropped. Within one millisecond events go in lifecycle order
+/// (start, prompt, tool, notification, tool done, stop, end).
+/// Events without a client time bypass the window, and so do
+/// notifications that block the agent on the user: they are applied on
+/// arrival, with the held events of their session stamped before them.
+/// A session silent for _idle_session_ttl with nothing held is forgotten.
+class Claude_event_reorder {
+ public:
+  using Apply = std::function< void(const Claude_reported_event& event)>;
+
+  Claude_event_reorder(std::chrono::milliseconds window, Apply apply);
+
+  Claude_event_reorder(const Claude_event_reorder&) = delete;
+  Claude_event_reorder& operator =(const Claude_event_reorder&) = delete;
+
+  /// Hold @p event, or apply it at once if it has no client time.
+  /// @return false if it was stale and dropped.
+  bool submit(const Claude_reported_event& event);
+
+  /// Apply every held event now.
+  void flush();
+
+ private:
+  /// Workspace name and session id as sent by the client.
+  using Session_key = std::pair< QString, QString>;
+  /// Client time, lifecycle rank: the order events of a session apply in.
+  using Order = std::pair< qint64, int>;
+
+  struct Held_event {
+    Order order;
+    quint64 seq = 0;  ///< Arrival number, breaks remaining ties
+    Claude_reported_event event;
+  };
+
+  struct Session_queue {
+    std::vector< Held_event> held;  ///< Sorted by (order, seq)
+    Order last_applied{0, -1};
+    qint64 ended_at_ms = -1;        ///< _clock time of its SESSION_END, -1 while running
+    qint64 last_event_ms = 0;       ///< _clock time of its last submitted event
+  };
+
+  void on_release_timer();
+  /// Apply the held events of @p key up to and including arrival @p seq.
+  void release_through(const Session_key& key, quint64 seq);
+  void apply_held(const Session_key& key, Session_queue& queue, std::vector< Held_event> due);
+  void forget_ended_sessions(qint64 now_ms);
+  void forget_idle_sessions(qint64 now_ms);
+  void arm_release_timer();
+
+  static int lifecycle_rank(Claude_event event);
+  /// A permission prompt or elicitation dialog, which puts the session in
+  /// WAITING: the user should see it without the window's delay.
+  static bool blocks_on_user(const Claude_reported_event& event);
+
+  /// Ended sessions stay this long, so their late events are found stale
+  /// instead of starting the session over.
+  static constexpr auto _ended_session_ttl = std::chrono::minutes(1);
+  /// Running sessions idle this long are forgotten, so sessions that never
+  /// send SESSION_END do not accumulate. Checked once per period.
+  static constexpr auto _idle_session_ttl = std::chrono::minutes(10);
+
+  std::chrono::milliseconds _window;
+  Apply _apply;
+  QElapsedTimer _clock;
+  QTimer _release_timer;
+  quint64 _next_seq = 0;
+  qint64 _next_idle_check_ms = 0;
+
+  QHash< Session_key, Session_queue> _sessions;
+  /// (release time, session, arrival) per held event, in arrival order and
+  /// so in release order; entries of events already applied are skipped.
+  std::deque< std::tuple< qint64, Session_key, quint64>> _releases;
+  /// (end time, session) in end order.
+  std::deque< std::pair< qint64, Session_key>> _ended;
+};
@@ -0,0 +1,130 @@
+#include "claude_event_socket.h"
+#include "claude_event_frame.h"
+#include "claude_status_tracker.h"
+#include "journal_log.h"
+
+#include <QSocketNotifier>
+#include <QStandardPaths>
+#include <QStringList>
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+Claude_event_socket::Claude_event_socket(Claude_status_tracker& tracker, QObject* parent)
+  : QObject(parent)
+  , _tracker(tracker)
+{
+}
+
+Claude_event_socket::~Claude_event_socket() {
+  if (_fd >= 0) {
+    close(_fd);
+    unlink(_path.toLocal8Bit().constData());
+  }
+}
+
+bool Claude_event_socket::start() {
+  auto runtime_dir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+  if (runtime_dir.isEmpty()) {
+    qCWarning(logClaude, "no runtime directory, Claude event socket disabled");
+    return false;
+  }
+  _path = runtime_dir + "/" + claude_event_socket_name;
+  auto path = _path.toLocal8Bit();
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (static_cast< size_t>(path.size()) >= sizeof(address.sun_path)) {
+    qCWarning(logClaude, "Claude event socket path too long: %s", path.constData());
+    return false;
+  }
+  std::memcpy(address.sun_path, path.constData(), static_cast< size_t>(path.size()));
+
+  _fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (_fd < 0) {
+    qCWarning(logClaude, "failed to create Claude event socket: %s", std::strerror(errno));
+    return false;
+  }
+
+  unlink(path.constData());
+  if (bind(_fd, reinterpret_cast< sockaddr*>(&address), sizeof(address)) < 0) {
+    qCWarning(logClaude, "failed to bind Claude event socket %s: %s", path.constData(), std::strerror(errno));
+    close(_fd);
+    _fd = -1;
+    return false;
+  }
+
+  // Room for a burst of tool calls while the GUI thread is busy.
+  int receive_buffer = 1 << 20;
+  setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer));
+
+  _buffers.resize(static_cast< size_t>(_batch_size) * Claude_event_frame::max_size);
+  _notifier = new QSocketNotifier(_fd, QSocketNotifier::Read, this);
+  connect(_notifier, &QSocketNotifier::activated, this, &Claude_event_socket::on_readable);
+
+  qCInfo(logClaude, "listening for Claude events on %s", path.constData());
+  return true;
+}
+
+void Claude_event_socket::on_readable() {
+  mmsghdr messages[_batch_size];
+  iovec vectors[_batch_size];
+
+  for (int batch = 0; batch < _max_batches_per_wakeup; ++batch) {
+    for (int i = 0; i < _batch_size; ++i) {
+      vectors[i].iov_base = _buffers.data() + static_cast< size_t>(i) * Claude_event_frame::max_size;
+      vectors[i].iov_len = Claude_event_frame::max_size;
+      messages[i] = {};
+      messages[i].msg_hdr.msg_iov = &vectors[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    auto count = recvmmsg(_fd, messages, _batch_size, MSG_DONTWAIT, nullptr);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        qCWarning(logClaude, "Claude event socket read failed: %s", std::strerror(errno));
+      }
+      return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+      if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+        qCWarning(logClaude, "dropped oversized Claude event datagram");
+        continue;
+      }
+      dispatch({static_cast< const char*>(vectors[i].iov_base), messages[i].msg_len});
+    }
+
+    if (count < _batch_size) {
+      return;
+    }
+  }
+}
+
+void Claude_event_socket::dispatch(std::string_view datagram) {
+  auto frame = decode_claude_event_frame(datagram);
+  if (!frame) {
+    qCWarning(logClaude, "malformed Claude event datagram (%zu bytes)", datagram.size());
+    return;
+  }
+
+  QStringList args;
+  args.reserve(static_cast< int>(frame->args.size()));
+  for (auto arg : frame->args) {
+    args.append(QString::fromUtf8(arg.data(), static_cast< int>(arg.size())));
+  }
+
+  auto target = QString::fromUtf8(frame->target.data(), static_cast< int>(frame->target.size()));
+  if (frame->target_is_path) {
+    _tracker.process_event_for_path(target, frame->event, args, frame->client_time_ms);
+  }
+  else {
+    _tracker.process_event(target, frame->event, args, frame->client_time_ms);
+  }
+}
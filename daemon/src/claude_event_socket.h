@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <string_view>
+#include <vector>
+
+class QSocketNotifier;
+class Claude_status_tracker;
+
+/// Unix datagram socket taking Claude events from hook clients, one
+/// Claude_event_frame per datagram. Writers never wait on the daemon: a
+/// send either lands in the socket buffer or fails at once. Each wakeup
+/// drains pending datagrams in recvmmsg() batches. Frames may name the
+/// workspace or carry a cwd that is resolved here; events outside any
+/// workspace are dropped.
+/// The ReportClaudeEvent D-Bus method stays as the compatibility path.
+class Claude_event_socket : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit Claude_event_socket(Claude_status_tracker& tracker, QObject* parent = nullptr);
+  ~Claude_event_socket() override;
+
+  Claude_event_socket(const Claude_event_socket&) = delete;
+  Claude_event_socket& operator =(const Claude_event_socket&) = delete;
+
+  /// Bind the socket in the runtime directory. @return false on failure.
+  bool start();
+
+ private:
+  void on_readable();
+  void dispatch(std::string_view datagram);
+
+  static constexpr int _batch_size = 32;
+  /// Upper bound of recvmmsg() calls per wakeup, so a flood cannot starve
+  /// the event loop; the notifier fires again for the rest.
+  static constexpr int _max_batches_per_wakeup = 8;
+
+  Claude_status_tracker& _tracker;
+  QString _path;
+  int _fd = -1;
+  QSocketNotifier* _notifier = nullptr;
+  /// _batch_size receive buffers of Claude_event_frame::max_size each.
+  std::vector< char> _buffers;
+};
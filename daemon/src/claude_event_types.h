@@ -1,6 +1,6 @@
 #pragma once
 
-#include <claude_types.h>
+// No Qt here: shared with the claude-status-hook client, which does not link Qt.
 
 /// Event types received from hook scripts.
 enum class Claude_event {
@@ -19,3 +19,16 @@ enum class Claude_notification {
   ELICITATION_DIALOG,
   IDLE_PROMPT
 };
+
+/// Position of the session id in an event's args, after the event's own
+/// args (tool name for WORKING, type and message for NOTIFICATION).
+/// SESSION_START carries the session id first, then the agent's PID.
+/// Older clients omit the session id; such events go to the workspace's
+/// only session.
+constexpr int claude_event_session_arg(Claude_event event) {
+  switch (event) {
+    case Claude_event::WORKING:      return 1;
+    case Claude_event::NOTIFICATION: return 2;
+    default:                         return 0;
+  }
+}
@@ -0,0 +1,287 @@
+// claude-status-hook: native replacement for hooks/claude-status-hook.sh.
+// Claude Code runs it on every hook event with the event JSON on stdin.
+// The event goes out as one datagram carrying the cwd; the daemon resolves
+// the workspace. If the daemon's event socket is unavailable, it falls back
+// to one ReportClaudeEventForPathAt D-Bus message. Both carry the time the
+// hook started, by which the daemon orders events of a session.
+// SessionStart also carries the agent's PID, so the daemon notices a session
+// whose process exits without SessionEnd.
+// Links neither Qt nor jq/qdbus, so an event costs one short-lived process
+// instead of several process launches.
+// Always exits 0: a failed status report must never disturb Claude.
+
+#include "claude_event_frame.h"
+#include "hook_json_reader.h"
+
+#include <magic_enum.hpp>
+
+#include <systemd/sd-bus.h>
+#include <systemd/sd-journal.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr const char* status_service   = "org.workspace.StatusMonitor";
+constexpr const char* status_path      = "/StatusMonitor";
+constexpr const char* status_interface = "org.workspace.StatusMonitor";
+
+/// Field order of the Hook_json_reader below.
+enum Field : size_t {
+  HOOK_EVENT_NAME,
+  CWD,
+  TOOL_NAME,
+  NOTIFICATION_TYPE,
+  NOTIFICATION_MESSAGE,
+  SESSION_ID
+};
+
+/// Same conversion as to_wire_string() in enum_strings.h, without QString.
+template< typename E>
+std::string wire_string(E value) {
+  std::string result(magic_enum::enum_name(value));
+  for (auto& c : result) {
+    c = static_cast< char>(std::tolower(static_cast< unsigned char>(c)));
+  }
+  return result;
+}
+
+struct Hook_event {
+  Claude_event type;
+  std::vector< std::string> args;
+  int64_t time_ms = 0;  ///< When the hook started (epoch ms)
+};
+
+int64_t now_ms() {
+  timespec now{};
+  clock_gettime(CLOCK_REALTIME, &now);
+  return static_cast< int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+/// Name and PPid fields of /proc/<pid>/status, the same fields
+/// hooks/claude-status-hook.sh reads. Empty name if the process is gone.
+std::pair< std::string, pid_t> proc_status(pid_t pid) {
+  std::pair< std::string, pid_t> result{{}, 0};
+  FILE* file = std::fopen(("/proc/" + std::to_string(pid) + "/status").c_str(), "r");
+  if (!file) {
+    return result;
+  }
+  char line[256];
+  while (std::fgets(line, sizeof(line), file)) {
+    if (std::strncmp(line, "Name:", 5) == 0) {
+      char name[64] = {};
+      std::sscanf(line + 5, " %63s", name);
+      result.first = name;
+    }
+    else if (std::strncmp(line, "PPid:", 5) == 0) {
+      std::sscanf(line + 5, " %d", &result.second);
+      break;
+    }
+  }
+  std::fclose(file);
+  return result;
+}
+
+/// Claude Code may run the hook through a shell; the agent is the nearest
+/// ancestor that is not one. Read from /proc, only on SessionStart.
+/// @return 0 if no such ancestor is found within four levels; the daemon
+/// then falls back to its timeout instead of watching a wrong process.
+pid_t agent_pid() {
+  pid_t pid = getppid();
+  for (int depth = 0; depth < 4 && pid > 1; ++depth) {
+    auto [name, parent] = proc_status(pid);
+    if (name.empty()) {
+      return 0;
+    }
+    if (name != "sh" && name != "bash" && name != "dash" && name != "zsh") {
+      return pid;
+    }
+    pid = parent;
+  }
+  return 0;
+}
+
+/// Args travel tab-separated over D-Bus; a tab inside a value would split it.
+std::string join_args_tsv(const std::vector< std::string>& args) {
+  std::string result;
+  for (size_t i = 0; i < args.size(); ++i) {
+    if (i > 0) {
+      result += '\t';
+    }
+    for (char c : args[i]) {
+      result += c == '\t' ? ' ' : c;
+    }
+  }
+  return result;
+}
+
+/// Map a Claude Code hook event to the daemon event, as the shell hook does.
+std::optional< Hook_event> map_event(const Hook_json_reader& json) {
+  const auto& name = json.value(HOOK_EVENT_NAME);
+
+  if (name == "PreToolUse") {
+    auto tool = json.value(TOOL_NAME);
+    return Hook_event{Claude_event::WORKING, {tool.empty() ? "unknown" : tool}};
+  }
+  if (name == "PostToolUse") {
+    return Hook_event{Claude_event::POST_TOOL, {}};
+  }
+  if (name == "Stop") {
+    return Hook_event{Claude_event::STOP, {}};
+  }
+  if (name == "UserPromptSubmit") {
+    return Hook_event{Claude_event::PROMPT_SUBMIT, {}};
+  }
+  if (name == "SessionStart") {
+    auto session_id = json.value(SESSION_ID);
+    return Hook_event{Claude_event::SESSION_START,
+      {session_id.empty() ? "unknown" : session_id, std::to_string(agent_pid())}};
+  }
+  if (name == "SessionEnd") {
+    return Hook_event{Claude_event::SESSION_END, {}};
+  }
+  if (name == "Notification") {
+    const auto& type = json.value(NOTIFICATION_TYPE);
+    if (type == wire_string(Claude_notification::PERMISSION_PROMPT)
+      || type == wire_string(Claude_notification::ELICITATION_DIALOG))
+    {
+      return Hook_event{Claude_event::NOTIFICATION, {type, json.value(NOTIFICATION_MESSAGE)}};
+    }
+    if (type == wire_string(Claude_notification::IDLE_PROMPT)) {
+      return Hook_event{Claude_event::NOTIFICATION, {type}};
+    }
+    sd_journal_send(
+      "MESSAGE=unknown notification type '%s' for cwd '%s'", type.c_str(), json.value(CWD).c_str(),
+      "PRIORITY=%i", LOG_WARNING,
+      "SYSLOG_IDENTIFIER=claude-hook",
+      nullptr);
+    return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+/// Stream stdin through @p json in fixed-size chunks.
+bool read_stdin(Hook_json_reader& json) {
+  char buffer[64 * 1024];
+  for (;;) {
+    auto n = read(STDIN_FILENO, buffer, sizeof(buffer));
+    if (n == 0) {
+      return json.finish();
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (!json.feed({buffer, static_cast< size_t>(n)})) {
+      return false;
+    }
+  }
+}
+
+/// Hand the event to the daemon's datagram socket without waiting for it.
+/// @return false if the socket is missing or its queue is full.
+bool send_datagram(const std::string& cwd, const Hook_event& event) {
+  const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+  if (!runtime_dir || !*runtime_dir) {
+    return false;
+  }
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  auto path = std::string(runtime_dir) + "/" + claude_event_socket_name;
+  if (path.size() >= sizeof(address.sun_path)) {
+    return false;
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size());
+
+  int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return false;
+  }
+  auto frame = encode_claude_event_frame(event.type, true, cwd, event.args, event.time_ms);
+  auto sent = sendto(fd, frame.data(), frame.size(), MSG_DONTWAIT,
+    reinterpret_cast< const sockaddr*>(&address), sizeof(address));
+  close(fd);
+  return sent == static_cast< ssize_t>(frame.size());
+}
+
+/// Fallback when the event socket is unavailable: one no-reply D-Bus
+/// message, the daemon resolves the workspace from cwd.
+void send_dbus(const std::string& cwd, const Hook_event& event) {
+  sd_bus* raw_bus = nullptr;
+  if (sd_bus_open_user(&raw_bus) < 0) {
+    return;
+  }
+  std::unique_ptr< sd_bus, decltype(&sd_bus_flush_close_unref)> bus(raw_bus, &sd_bus_flush_close_unref);
+
+  sd_bus_message* raw_call = nullptr;
+  if (sd_bus_message_new_method_call(bus.get(), &raw_call,
+    status_service, status_path, status_interface, "ReportClaudeEventForPathAt") < 0)
+  {
+    return;
+  }
+  std::unique_ptr< sd_bus_message, decltype(&sd_bus_message_unref)> call(raw_call, &sd_bus_message_unref);
+
+  // Sent without expecting a reply; sd_bus_flush_close_unref() pushes it out on exit.
+  auto event_type = wire_string(event.type);
+  auto args_tsv = join_args_tsv(event.args);
+  if (sd_bus_message_append(call.get(), "sssx",
+      cwd.c_str(), event_type.c_str(), args_tsv.c_str(), event.time_ms) < 0
+    || sd_bus_message_set_expect_reply(call.get(), 0) < 0)
+  {
+    return;
+  }
+  sd_bus_send(bus.get(), call.get(), nullptr);
+}
+
+} // namespace
+
+int main() {
+  // Before reading stdin: hooks run concurrently and reach the daemon in
+  // any order, so the event is stamped as early as possible.
+  auto started_ms = now_ms();
+
+  Hook_json_reader json({
+    "hook_event_name",
+    "cwd",
+    "tool_name",
+    "notification.type",
+    "notification.message",
+    "session_id"
+  });
+  if (!read_stdin(json) || json.value(HOOK_EVENT_NAME).empty() || json.value(CWD).empty()) {
+    return 0;
+  }
+
+  auto event = map_event(json);
+  if (!event) {
+    return 0;
+  }
+  if (event->type != Claude_event::SESSION_START) {
+    event->args.resize(claude_event_session_arg(event->type));
+    event->args.push_back(json.value(SESSION_ID));
+  }
+  event->time_ms = started_ms;
+
+  if (!send_datagram(json.value(CWD), *event)) {
+    send_dbus(json.value(CWD), *event);
+  }
+  return 0;
+}
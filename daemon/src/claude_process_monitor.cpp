@@ -0,0 +1,93 @@
+#include "claude_process_monitor.h"
+#include "journal_log.h"
+
+#include <QSocketNotifier>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/// pidfd_open(2) through syscall(): glibc before 2.36 has no wrapper.
+static int open_pidfd(qint64 pid) {
+#ifdef SYS_pidfd_open
+  return static_cast< int>(syscall(SYS_pidfd_open, static_cast< pid_t>(pid), 0));
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+Claude_process_monitor::Claude_process_monitor(QObject* parent)
+  : QObject(parent)
+{
+}
+
+Claude_process_monitor::~Claude_process_monitor() {
+  for (const auto& watch : _watches) {
+    release(watch);
+  }
+}
+
+bool Claude_process_monitor::watch(const QString& workspace, const QString& session_id, qint64 pid) {
+  unwatch(workspace, session_id);
+
+  int fd = open_pidfd(pid);
+  if (fd < 0) {
+    if (errno == ESRCH) {
+      // Exited between its hook and here; report it like any other exit,
+      // outside the caller's event processing.
+      qCInfo(logClaude, "'%s' session %s: agent process %" PRId64 " already gone",
+        qPrintable(workspace), qPrintable(session_id), static_cast< int64_t>(pid));
+      QMetaObject::invokeMethod(this, [this, workspace, session_id, pid] {
+        emit process_exited(workspace, session_id, pid);
+      }, Qt::QueuedConnection);
+    }
+    else {
+      qCWarning(logClaude, "'%s' session %s: cannot watch agent process %" PRId64 ": %s",
+        qPrintable(workspace), qPrintable(session_id), static_cast< int64_t>(pid), std::strerror(errno));
+    }
+    return false;
+  }
+
+  Session_key key{workspace, session_id};
+  auto* notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+  connect(notifier, &QSocketNotifier::activated, this, [this, key] { on_exited(key); });
+  _watches.insert(key, Watch{pid, fd, notifier});
+  return true;
+}
+
+void Claude_process_monitor::unwatch(const QString& workspace, const QString& session_id) {
+  auto it = _watches.find({workspace, session_id});
+  if (it == _watches.end()) {
+    return;
+  }
+  release(it.value());
+  _watches.erase(it);
+}
+
+bool Claude_process_monitor::is_watching(const QString& workspace, const QString& session_id) const {
+  return _watches.contains({workspace, session_id});
+}
+
+void Claude_process_monitor::on_exited(const Session_key& key) {
+  auto it = _watches.find(key);
+  if (it == _watches.end()) {
+    return;
+  }
+  auto pid = it->pid;
+  release(it.value());
+  _watches.erase(it);
+
+  emit process_exited(key.first, key.second, pid);
+}
+
+void Claude_process_monitor::release(const Watch& watch) {
+  // Disabled before the close, and deleted later: this may run from the
+  // notifier's own activated signal.
+  watch.notifier->setEnabled(false);
+  watch.notifier->deleteLater();
+  close(watch.fd);
+}
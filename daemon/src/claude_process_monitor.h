@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+#include <utility>
+
+class QSocketNotifier;
+
+/// Watches the agent processes of Claude sessions through pidfds. A pidfd
+/// becomes readable when its process exits, so a session whose agent dies
+/// without a SessionEnd hook (killed, crashed, terminal closed) is seen the
+/// moment it happens, with no polling and no timeout guesswork. Each watch
+/// holds one descriptor and one QSocketNotifier until its process exits or
+/// the session is unwatched.
+class Claude_process_monitor : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit Claude_process_monitor(QObject* parent = nullptr);
+  ~Claude_process_monitor() override;
+
+  Claude_process_monitor(const Claude_process_monitor&) = delete;
+  Claude_process_monitor& operator =(const Claude_process_monitor&) = delete;
+
+  /// Watch @p pid for the session, replacing any earlier watch of it.
+  /// If the process is already gone, process_exited is emitted from the
+  /// event loop. @return false if the process cannot be watched (no pidfd
+  /// support, or it exited).
+  bool watch(const QString& workspace, const QString& session_id, qint64 pid);
+  void unwatch(const QString& workspace, const QString& session_id);
+  bool is_watching(const QString& workspace, const QString& session_id) const;
+
+ signals:
+  /// The session's agent process exited; the watch is already released.
+  void process_exited(const QString& workspace, const QString& session_id, qint64 pid);
+
+ private:
+  /// Workspace name and session id.
+  using Session_key = std::pair< QString, QString>;
+
+  struct Watch {
+    qint64 pid = 0;
+    int fd = -1;
+    QSocketNotifier* notifier = nullptr;
+  };
+
+  void on_exited(const Session_key& key);
+  static void release(const Watch& watch);
+
+  QHash< Session_key, Watch> _watches;
+};
@@ -0,0 +1,52 @@
+#include "claude_status_coalescer.h"
+#include "claude_status_tracker.h"
+
+Claude_status_coalescer::Claude_status_coalescer(Claude_status_tracker& tracker, QObject* parent)
+  : QObject(parent)
+{
+  _frame_timer.setSingleShot(true);
+  _frame_timer.setTimerType(Qt::PreciseTimer);
+  _frame_timer.setInterval(_frame_interval);
+  connect(&_frame_timer, &QTimer::timeout, this, &Claude_status_coalescer::flush);
+
+  for (const auto& status : tracker.all_statuses()) {
+    _emitted_state.insert(status.workspace_name, status.state);
+  }
+
+  connect(&tracker, &Claude_status_tracker::status_changed,
+    this, &Claude_status_coalescer::on_status_changed);
+}
+
+void Claude_status_coalescer::on_status_changed(const Claude_workspace_status& status) {
+  if (!_pending.contains(status.workspace_name)) {
+    _pending_order.append(status.workspace_name);
+  }
+  _pending.insert(status.workspace_name, status);
+
+  if (status.state == Claude_state::WAITING
+    && _emitted_state.value(status.workspace_name, Claude_state::NOT_RUNNING) != Claude_state::WAITING)
+  {
+    flush();
+  }
+  else if (!_frame_timer.isActive()) {
+    _frame_timer.start();
+  }
+}
+
+void Claude_status_coalescer::flush() {
+  _frame_timer.stop();
+  if (_pending_order.isEmpty()) {
+    return;
+  }
+
+  QVector< Claude_workspace_status> statuses;
+  statuses.reserve(_pending_order.size());
+  for (const auto& workspace : _pending_order) {
+    auto status = _pending.take(workspace);
+    _emitted_state.insert(workspace, status.state);
+    statuses.append(status);
+  }
+  _pending_order.clear();
+
+  emit statuses_changed(statuses);
+}
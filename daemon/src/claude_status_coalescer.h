@@ -0,0 +1,42 @@
+#pragma once
+
+#include <claude_types.h>
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include <chrono>
+
+class Claude_status_tracker;
+
+/// Collapses Claude_status_tracker::status_changed bursts into one
+/// statuses_changed batch per frame: each workspace appears once, with its
+/// latest status, in order of its first change. The first change after a
+/// quiet period starts the frame timer; later ones do not restart it, so a
+/// change is delivered at most one frame late. A workspace newly entering
+/// WAITING (an agent blocked on the user) flushes the batch at once;
+/// further updates while it stays WAITING wait for the frame like any other.
+class Claude_status_coalescer : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit Claude_status_coalescer(Claude_status_tracker& tracker, QObject* parent = nullptr);
+
+ signals:
+  void statuses_changed(const QVector< Claude_workspace_status>& statuses);
+
+ private:
+  void on_status_changed(const Claude_workspace_status& status);
+  void flush();
+
+  static constexpr auto _frame_interval = std::chrono::milliseconds(25);
+
+  QTimer _frame_timer;
+  QHash< QString, Claude_workspace_status> _pending;
+  QStringList _pending_order;
+  /// State of each workspace as last emitted (or at startup).
+  QHash< QString, Claude_state> _emitted_state;
+};
@@ -4,18 +4,61 @@
 
 #include <QDBusConnection>
 #include <QDBusError>
+#include <QDBusMetaType>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 
-Claude_status_dbus::Claude_status_dbus(Claude_status_tracker& tracker)
+QDBusArgument& operator <<(QDBusArgument& argument, const Claude_event_report& report) {
+  argument.beginStructure();
+  argument << report.workspace << report.event_type << report.args_tsv << report.client_ts_ms;
+  argument.endStructure();
+  return argument;
+}
+
+const QDBusArgument& operator >>(const QDBusArgument& argument, Claude_event_report& report) {
+  argument.beginStructure();
+  argument >> report.workspace >> report.event_type >> report.args_tsv >> report.client_ts_ms;
+  argument.endStructure();
+  return argument;
+}
+
+static QJsonObject histogram_json(const Latency_histogram& histogram) {
+  QJsonObject obj;
+  obj["count"] = static_cast< qint64>(histogram.count());
+  obj["min_ms"] = static_cast< qint64>(histogram.min());
+  obj["mean_ms"] = histogram.mean();
+  obj["p50_ms"] = static_cast< qint64>(histogram.value_at_percentile(50));
+  obj["p90_ms"] = static_cast< qint64>(histogram.value_at_percentile(90));
+  obj["p99_ms"] = static_cast< qint64>(histogram.value_at_percentile(99));
+  obj["max_ms"] = static_cast< qint64>(histogram.max());
+  return obj;
+}
+
+static QJsonObject timings_json(const Claude_workspace_timings& timings) {
+  QJsonObject tools;
+  for (auto it = timings.tool_ms.cbegin(); it != timings.tool_ms.cend(); ++it) {
+    tools[it.key()] = histogram_json(it.value());
+  }
+
+  QJsonObject obj;
+  obj["tools"] = tools;
+  obj["first_tool"] = histogram_json(timings.first_tool_ms);
+  obj["waiting"] = histogram_json(timings.waiting_ms);
+  return obj;
+}
+
+Claude_status_dbus::Claude_status_dbus(Claude_status_tracker& tracker, Claude_status_coalescer& coalescer)
   : QDBusAbstractAdaptor(&tracker)
   , _tracker(tracker)
 {
   setAutoRelaySignals(false);
+  qDBusRegisterMetaType< Claude_event_report>();
+  qDBusRegisterMetaType< QList< Claude_event_report>>();
+  qDBusRegisterMetaType< QMap< QString, QVariantMap>>();
 
-  connect(&_tracker, &Claude_status_tracker::status_changed,
-    this, &Claude_status_dbus::on_status_changed);
+  connect(&coalescer, &Claude_status_coalescer::statuses_changed,
+    this, &Claude_status_dbus::on_statuses_changed);
 
   auto bus = QDBusConnection::sessionBus();
   if (!bus.isConnected()) {
@@ -47,12 +90,64 @@ QString Claude_status_dbus::GetAllStatuses() {
     obj["wait_reason"] = status.wait_reason;
     obj["wait_message"] = status.wait_message;
     obj["state_since_ms"] = status.state_since_ms;
+
+    QJsonArray sessions;
+    for (const auto& session : status.sessions) {
+      QJsonObject session_obj;
+      session_obj["session_id"] = session.session_id;
+      session_obj["state"] = to_wire_string(session.state);
+      session_obj["tool_name"] = session.tool_name;
+      session_obj["wait_reason"] = session.wait_reason;
+      session_obj["wait_message"] = session.wait_message;
+      session_obj["state_since_ms"] = session.state_since_ms;
+      sessions.append(session_obj);
+    }
+    obj["sessions"] = sessions;
     array.append(obj);
   }
 
   return QJsonDocument(array).toJson(QJsonDocument::Compact);
 }
 
+QString Claude_status_dbus::GetTrackerStats() {
+  const auto& stats = _tracker.stats();
+
+  QJsonObject obj;
+  obj["events"] = stats.events;
+  obj["changes"] = stats.changes;
+  obj["stale"] = stats.stale;
+  obj["total_ns"] = stats.total_ns;
+  obj["max_ns"] = stats.max_ns;
+  obj["mean_ns"] = stats.events > 0 ? stats.total_ns / stats.events : 0;
+
+  return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+QString Claude_status_dbus::GetTimingHistograms() {
+  QJsonObject workspaces;
+  Claude_workspace_timings total;
+  const auto& timings = _tracker.timings();
+  for (auto it = timings.cbegin(); it != timings.cend(); ++it) {
+    workspaces[it.key()] = timings_json(it.value());
+
+    for (auto tool = it->tool_ms.cbegin(); tool != it->tool_ms.cend(); ++tool) {
+      total.tool_ms[tool.key()].merge(tool.value());
+    }
+    total.first_tool_ms.merge(it->first_tool_ms);
+    total.waiting_ms.merge(it->waiting_ms);
+  }
+
+  QJsonObject obj;
+  obj["workspaces"] = workspaces;
+  obj["total"] = timings_json(total);
+
+  return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+void Claude_status_dbus::ResetTimingHistograms() {
+  _tracker.reset_timings();
+}
+
 void Claude_status_dbus::ReportClaudeEvent(
   const QString& workspace,
   const QString& event_type,
@@ -62,19 +157,73 @@ void Claude_status_dbus::ReportClaudeEvent(
   _tracker.process_event(workspace, event_type, args);
 }
 
-void Claude_status_dbus::on_status_changed(
-  const QString& workspace,
-  Claude_state state,
-  const QString& tool_name,
-  const QString& wait_reason,
-  const QString& wait_message,
-  qint64 state_since_ms
+void Claude_status_dbus::ReportClaudeEvents(const QList< Claude_event_report>& events) {
+  QVector< Claude_reported_event> batch;
+  batch.reserve(events.size());
+  for (const auto& report : events) {
+    auto event = from_wire_string< Claude_event>(report.event_type);
+    if (!event) {
+      qCWarning(logClaude, "unknown event type '%s' for workspace '%s' in batch",
+        qPrintable(report.event_type), qPrintable(report.workspace));
+      continue;
+    }
+    batch.append({report.workspace, *event, report.args_tsv.split('\t'), report.client_ts_ms});
+  }
+
+  _tracker.process_events(batch);
+}
+
+void Claude_status_dbus::ReportClaudeEventForPath(
+  const QString& cwd,
+  const QString& event_type,
+  const QString& args_tsv
 ) {
-  QVariantMap status;
-  status["state"] = to_wire_string(state);
-  status["tool_name"] = tool_name;
-  status["wait_reason"] = wait_reason;
-  status["wait_message"] = wait_message;
-  status["state_since_ms"] = state_since_ms;
-  emit StatusChanged(workspace, status);
+  auto event = from_wire_string< Claude_event>(event_type);
+  if (!event) {
+    qCWarning(logClaude, "unknown event type '%s' for path '%s'",
+      qPrintable(event_type), qPrintable(cwd));
+    return;
+  }
+
+  _tracker.process_event_for_path(cwd, *event, args_tsv.split('\t'));
+}
+
+void Claude_status_dbus::ReportClaudeEventForPathAt(
+  const QString& cwd,
+  const QString& event_type,
+  const QString& args_tsv,
+  qint64 client_ts_ms
+) {
+  auto event = from_wire_string< Claude_event>(event_type);
+  if (!event) {
+    qCWarning(logClaude, "unknown event type '%s' for path '%s'",
+      qPrintable(event_type), qPrintable(cwd));
+    return;
+  }
+
+  _tracker.process_event_for_path(cwd, *event, args_tsv.split('\t'), client_ts_ms);
+}
+
+void Claude_status_dbus::on_statuses_changed(const QVector< Claude_workspace_status>& statuses) {
+  QMap< QString, QVariantMap> batch;
+  for (const auto& status : statuses) {
+    QVariantMap entry;
+    entry["state"] = to_wire_string(status.state);
+    entry["tool_name"] = status.tool_name;
+    entry["wait_reason"] = status.wait_reason;
+    entry["wait_message"] = status.wait_message;
+    entry["state_since_ms"] = status.state_since_ms;
+
+    QVariantList sessions;
+    for (const auto& session : status.sessions) {
+      sessions.append(session.to_variant_map());
+    }
+    entry["sessions"] = sessions;
+    batch.insert(status.workspace_name, entry);
+  }
+  emit StatusesChanged(batch);
+
+  for (auto it = batch.cbegin(); it != batch.cend(); ++it) {
+    emit StatusChanged(it.key(), it.value());
+  }
 }
@@ -1,39 +1,94 @@
 #pragma once
 
+#include "claude_status_coalescer.h"
 #include "claude_status_tracker.h"
 
 #include <QDBusAbstractAdaptor>
+#include <QDBusArgument>
+#include <QList>
+#include <QMap>
+#include <QMetaType>
 #include <QString>
 #include <QVariantMap>
 
+/// Element (sssx) of ReportClaudeEvents.
+struct Claude_event_report {
+  QString workspace;
+  QString event_type;      ///< wire format, as in ReportClaudeEvent
+  QString args_tsv;
+  qint64 client_ts_ms = 0; ///< when the client saw the event (epoch ms), 0 if unknown
+};
+Q_DECLARE_METATYPE(Claude_event_report)
+
+QDBusArgument& operator <<(QDBusArgument& argument, const Claude_event_report& report);
+const QDBusArgument& operator >>(const QDBusArgument& argument, Claude_event_report& report);
+
 /// D-Bus adaptor exposing Claude Code status on org.workspace.StatusMonitor /StatusMonitor.
-/// Provides GetAllStatuses() method and StatusChanged() signal.
+/// Provides GetAllStatuses() method and the StatusesChanged() batch signal,
+/// fed by Claude_status_coalescer.
 class Claude_status_dbus : public QDBusAbstractAdaptor {
   Q_OBJECT
   Q_CLASSINFO("D-Bus Interface", "org.workspace.StatusMonitor")
 
  public:
-  explicit Claude_status_dbus(Claude_status_tracker& tracker);
+  Claude_status_dbus(Claude_status_tracker& tracker, Claude_status_coalescer& coalescer);
 
  public slots:
   /// Returns JSON array of workspace statuses:
-  /// [{name, state, tool_name, wait_reason, wait_message, state_since_ms}, ...]
+  /// [{name, state, tool_name, wait_reason, wait_message, state_since_ms, sessions}, ...]
+  /// where sessions is the per-session breakdown:
+  /// [{session_id, state, tool_name, wait_reason, wait_message, state_since_ms}, ...]
   QString GetAllStatuses();
 
+  /// Returns JSON object with event processing cost:
+  /// {events, changes, stale, total_ns, max_ns, mean_ns}
+  QString GetTrackerStats();
+
+  /// Returns JSON object with timing histograms per workspace and merged
+  /// over all of them:
+  /// {workspaces: {name: T, ...}, total: T}, T = {tools: {tool: H, ...}, first_tool: H, waiting: H},
+  /// H = {count, min_ms, mean_ms, p50_ms, p90_ms, p99_ms, max_ms}
+  QString GetTimingHistograms();
+
+  /// Clear all timing histograms.
+  void ResetTimingHistograms();
+
   void ReportClaudeEvent(const QString& workspace, const QString& event_type, const QString& args_tsv);
 
+  /// Apply a batch of events a(sssx): one storage transaction, one status
+  /// update per affected workspace. Events with a client time go in that
+  /// order per session, those without in batch order. For replay tools and hook
+  /// clients catching up. Events with an unknown type are skipped.
+  void ReportClaudeEvents(const QList< Claude_event_report>& events);
+
+  /// Like ReportClaudeEvent, with the workspace resolved from the hook's
+  /// cwd inside the daemon. Events outside every workspace are dropped.
+  /// One call per hook event instead of FindWorkspaceByPath + ReportClaudeEvent.
+  Q_NOREPLY void ReportClaudeEventForPath(const QString& cwd, const QString& event_type, const QString& args_tsv);
+
+  /// ReportClaudeEventForPath with the time the client saw the event
+  /// (epoch ms). Events of a session are applied in that order within a
+  /// short reorder window, stale ones dropped, and the time becomes the
+  /// state_since_ms of the state entered.
+  Q_NOREPLY void ReportClaudeEventForPathAt(
+    const QString& cwd,
+    const QString& event_type,
+    const QString& args_tsv,
+    qint64 client_ts_ms
+  );
+
  signals:
+  /// Statuses changed within one coalescing frame, a{sa{sv}}:
+  /// workspace name -> {state, tool_name, wait_reason, wait_message, state_since_ms,
+  /// sessions}, with sessions an array of per-session a{sv} as in GetAllStatuses.
+  void StatusesChanged(const QMap< QString, QVariantMap>& statuses);
+
+  /// Per-workspace form of StatusesChanged, emitted for each of its entries.
+  /// Kept for existing listeners.
   void StatusChanged(const QString& workspace_name, const QVariantMap& status);
 
  private:
-  void on_status_changed(
-    const QString& workspace,
-    Claude_state state,
-    const QString& tool_name,
-    const QString& wait_reason,
-    const QString& wait_message,
-    qint64 state_since_ms
-  );
+  void on_statuses_changed(const QVector< Claude_workspace_status>& statuses);
 
   Claude_status_tracker& _tracker;
 };
@@ -2,19 +2,47 @@
 #include "claude_event_types.h"
 #include "enum_strings.h"
 #include "journal_log.h"
-#include "workspace_db.h"
+#include "workspace_storage.h"
 
 #include <QDateTime>
+#include <QElapsedTimer>
 
+#include <algorithm>
 #include <cinttypes>
 
-Claude_status_tracker::Claude_status_tracker(Workspace_db& db, QObject* parent)
+Claude_status_tracker::Claude_status_tracker(Workspace_storage& db, QObject* parent)
   : QObject(parent)
   , _db(db)
+  , _reorder(_reorder_window, [this](const Claude_reported_event& event) {
+      apply_event(event.workspace, event.event, event.args,
+        event.client_ts_ms > 0 ? event.client_ts_ms : QDateTime::currentMSecsSinceEpoch());
+    })
 {
-  _timeout_timer.setInterval(std::chrono::seconds(30));
+  // Single shot, re-armed to the nearest deadline; idle when nothing is busy.
+  _timeout_timer.setSingleShot(true);
+  _timeout_timer.setTimerType(Qt::PreciseTimer);
   connect(&_timeout_timer, &QTimer::timeout, this, &Claude_status_tracker::check_timeouts);
-  _timeout_timer.start();
+  connect(&_processes, &Claude_process_monitor::process_exited,
+    this, &Claude_status_tracker::on_process_exited);
+
+  for (const auto& status : _db.all_claude_statuses()) {
+    auto& restored = *_statuses.insert(status.workspace_name, status);
+    restored.sessions = {Claude_session_status{
+      .session_id = status.session_id,
+      .state = status.state,
+      .tool_name = status.tool_name,
+      .wait_reason = status.wait_reason,
+      .wait_message = status.wait_message,
+      .state_since_ms = status.state_since_ms
+    }};
+
+    _restored_sessions.insert(status.workspace_name, status.session_id);
+    auto& sessions = _session_sets[status.workspace_name];
+    sessions.index.insert(status.session_id, 0);
+    sessions.by_state[static_cast< size_t>(status.state)].insert(status.session_id);
+    update_deadline({status.workspace_name, status.session_id}, status.state);
+  }
+  arm_timeout_timer();
 }
 
 void Claude_status_tracker::process_event(
@@ -22,8 +50,6 @@ void Claude_status_tracker::process_event(
   const QString& event_type,
   const QStringList& args
 ) {
-  qCInfo(logClaude, "'%s' event=%s", qPrintable(workspace), qPrintable(event_type));
-
   auto event = from_wire_string< Claude_event>(event_type);
   if (!event) {
     qCWarning(logClaude, "unknown event type '%s' for workspace '%s'",
@@ -31,139 +57,533 @@ void Claude_status_tracker::process_event(
     return;
   }
 
-  switch (*event) {
-    case Claude_event::SESSION_START:  handle_session_start(workspace, args);  break;
-    case Claude_event::PROMPT_SUBMIT:  handle_prompt_submit(workspace, args);  break;
-    case Claude_event::WORKING:        handle_working(workspace, args);        break;
-    case Claude_event::POST_TOOL:      handle_post_tool(workspace, args);      break;
-    case Claude_event::STOP:           handle_stop(workspace, args);           break;
-    case Claude_event::NOTIFICATION:   handle_notification(workspace, args);   break;
-    case Claude_event::SESSION_END:    handle_session_end(workspace, args);    break;
+  process_event(workspace, *event, args);
+}
+
+void Claude_status_tracker::process_event(
+  const QString& workspace,
+  Claude_event event,
+  const QStringList& args,
+  qint64 client_ts_ms
+) {
+  qCInfo(logClaude, "'%s' event=%s", qPrintable(workspace), qPrintable(to_wire_string(event)));
+  if (!_reorder.submit({workspace, event, args, client_ts_ms})) {
+    ++_stats.stale;
+  }
+}
+
+void Claude_status_tracker::process_events(const QVector< Claude_reported_event>& events) {
+  QElapsedTimer elapsed;
+  elapsed.start();
+
+  _in_batch = true;
+  _db.begin_claude_batch();
+  for (const auto& event : events) {
+    if (!_reorder.submit(event)) {
+      ++_stats.stale;
+    }
   }
+  // The batch is complete, nothing in it needs to wait.
+  _reorder.flush();
+  _db.end_claude_batch();
+  _in_batch = false;
+
+  auto changes = std::exchange(_batch_changes, {});
+  auto order = std::exchange(_batch_order, {});
+  for (const auto& workspace : order) {
+    emit status_changed(*changes.constFind(workspace));
+  }
+
+  qCInfo(logClaude, "applied %d events, %d workspaces changed, in %lld us",
+    static_cast< int>(events.size()), static_cast< int>(order.size()),
+    static_cast< long long>(elapsed.nsecsElapsed() / 1000));
+}
+
+void Claude_status_tracker::apply_event(
+  const QString& workspace,
+  Claude_event event,
+  const QStringList& args,
+  qint64 at_ms
+) {
+  // Measured without the journal write in process_event().
+  QElapsedTimer elapsed;
+  elapsed.start();
+
+  auto session_id = args.value(claude_event_session_arg(event));
+  if (session_id.isEmpty()) {
+    session_id = sole_session(workspace);
+  }
+
+  Session_key key{workspace, session_id};
+  switch (event) {
+    case Claude_event::SESSION_START:  handle_session_start(key, args, at_ms);  break;
+    case Claude_event::PROMPT_SUBMIT:  handle_prompt_submit(key, args, at_ms);  break;
+    case Claude_event::WORKING:        handle_working(key, args, at_ms);        break;
+    case Claude_event::POST_TOOL:      handle_post_tool(key, args, at_ms);      break;
+    case Claude_event::STOP:           handle_stop(key, args, at_ms);           break;
+    case Claude_event::NOTIFICATION:   handle_notification(key, args, at_ms);   break;
+    case Claude_event::SESSION_END:    handle_session_end(key, args, at_ms);    break;
+  }
+
+  // The restored session only carried the stored state. The first event of
+  // another session replaces it; events that resolve to it (same id, or no
+  // id from an older client) keep it as a real session from now on.
+  auto restored = _restored_sessions.find(workspace);
+  if (restored != _restored_sessions.end() && !session_id.isEmpty()) {
+    auto restored_id = restored.value();
+    _restored_sessions.erase(restored);
+    if (restored_id != session_id) {
+      remove_session({workspace, restored_id}, at_ms);
+    }
+  }
+
+  auto ns = elapsed.nsecsElapsed();
+  ++_stats.events;
+  _stats.total_ns += ns;
+  _stats.max_ns = std::max(_stats.max_ns, ns);
+}
+
+bool Claude_status_tracker::process_event_for_path(
+  const QString& path,
+  Claude_event event,
+  const QStringList& args,
+  qint64 client_ts_ms
+) {
+  auto workspace = _db.find_workspace_by_path(path);
+  if (workspace.isEmpty()) {
+    return false;
+  }
+
+  process_event(workspace, event, args, client_ts_ms);
+  return true;
 }
 
 void Claude_status_tracker::handle_session_start(
-  const QString& workspace, const QStringList& args
+  const Session_key& key, const QStringList& args, qint64 at_ms
 ) {
-  auto since = _db.start_claude_session(workspace, args.value(0));
-  if (since >= 0) {
-    emit status_changed(workspace, Claude_state::IDLE, {}, {}, {}, since);
+  // Before the state change, so a watched session gets no deadline.
+  auto pid = args.value(1).toLongLong();
+  if (pid > 0) {
+    _processes.watch(key.first, key.second, pid);
+  }
+  else {
+    _processes.unwatch(key.first, key.second);
   }
+
+  // A restarted or resumed session starts over in IDLE.
+  set_session_state(key, at_ms, Claude_state::IDLE);
 }
 
 void Claude_status_tracker::handle_prompt_submit(
-  const QString& workspace, const QStringList& /*args*/
+  const Session_key& key, const QStringList& /*args*/, qint64 at_ms
 ) {
-  set_state(workspace, Claude_state::REQUESTING);
+  set_session_state(key, at_ms, Claude_state::REQUESTING);
 }
 
 void Claude_status_tracker::handle_working(
-  const QString& workspace, const QStringList& args
+  const Session_key& key, const QStringList& args, qint64 at_ms
 ) {
-  set_state(workspace, Claude_state::WORKING, args.value(0));
+  set_session_state(key, at_ms, Claude_state::WORKING, args.value(0));
+  // After the state change, which credits a wait to the previous tool.
+  start_tool(key, args.value(0), at_ms);
 }
 
 void Claude_status_tracker::handle_post_tool(
-  const QString& workspace, const QStringList& /*args*/
+  const Session_key& key, const QStringList& /*args*/, qint64 at_ms
 ) {
-  auto current = _db.claude_status(workspace);
-  if (current && current->state == Claude_state::WORKING) {
-    auto since = _db.set_claude_state(workspace, Claude_state::WORKING, current->tool_name);
-    if (since >= 0) {
-      emit status_changed(workspace, Claude_state::WORKING, current->tool_name, {}, {}, since);
-    }
+  // A finished tool while WORKING changes nothing visible; it only proves
+  // the session is alive, so the timeout restarts without a write.
+  auto* session = find_session(key);
+  if (session && session->state == Claude_state::WORKING) {
+    update_deadline(key, Claude_state::WORKING);
+    arm_timeout_timer();
   }
   else {
-    set_state(workspace, Claude_state::WORKING);
+    set_session_state(key, at_ms, Claude_state::WORKING);
   }
+  finish_tool(key, at_ms);
 }
 
 void Claude_status_tracker::handle_stop(
-  const QString& workspace, const QStringList& /*args*/
+  const Session_key& key, const QStringList& /*args*/, qint64 at_ms
 ) {
-  set_state(workspace, Claude_state::IDLE);
+  set_session_state(key, at_ms, Claude_state::IDLE);
 }
 
 void Claude_status_tracker::handle_notification(
-  const QString& workspace, const QStringList& args
+  const Session_key& key, const QStringList& args, qint64 at_ms
 ) {
   auto type = from_wire_string< Claude_notification>(args.value(0));
   if (!type) {
     qCWarning(logClaude, "unknown notification type '%s' for workspace '%s'",
-      qPrintable(args.value(0)), qPrintable(workspace));
+      qPrintable(args.value(0)), qPrintable(key.first));
     return;
   }
 
   switch (*type) {
     case Claude_notification::PERMISSION_PROMPT:
     case Claude_notification::ELICITATION_DIALOG:
-      set_state(workspace, Claude_state::WAITING, {}, args.value(0), args.value(1));
+      set_session_state(key, at_ms, Claude_state::WAITING, {}, args.value(0), args.value(1));
       break;
     case Claude_notification::IDLE_PROMPT:
-      set_state(workspace, Claude_state::IDLE);
+      set_session_state(key, at_ms, Claude_state::IDLE);
       break;
   }
 }
 
 void Claude_status_tracker::handle_session_end(
-  const QString& workspace, const QStringList& /*args*/
+  const Session_key& key, const QStringList& /*args*/, qint64 at_ms
 ) {
-  auto since = _db.end_claude_session(workspace);
-  if (since >= 0) {
-    emit status_changed(workspace, Claude_state::NOT_RUNNING, {}, {}, {}, since);
+  remove_session(key, at_ms);
+}
+
+void Claude_status_tracker::on_process_exited(
+  const QString& workspace, const QString& session_id, qint64 pid
+) {
+  qCInfo(logClaude, "'%s' session %s: agent process %" PRId64 " exited",
+    qPrintable(workspace), qPrintable(session_id), static_cast< int64_t>(pid));
+  Claude_reported_event event{
+    workspace, Claude_event::SESSION_END, {session_id}, QDateTime::currentMSecsSinceEpoch()
+  };
+  if (!_reorder.submit(event)) {
+    ++_stats.stale;
   }
 }
 
 QVector< Claude_workspace_status> Claude_status_tracker::all_statuses() const {
-  return _db.all_claude_statuses();
+  QVector< Claude_workspace_status> result;
+  result.reserve(_statuses.size());
+  for (const auto& status : _statuses) {
+    result.append(status);
+  }
+  return result;
 }
 
-void Claude_status_tracker::set_state(
-  const QString& workspace,
+QString Claude_status_tracker::sole_session(const QString& workspace) const {
+  auto it = _session_sets.constFind(workspace);
+  if (it == _session_sets.cend() || it->index.size() != 1) {
+    return {};
+  }
+  return it->index.cbegin().key();
+}
+
+const Claude_session_status* Claude_status_tracker::find_session(const Session_key& key) const {
+  auto set = _session_sets.constFind(key.first);
+  if (set == _session_sets.cend()) {
+    return nullptr;
+  }
+  auto position = set->index.constFind(key.second);
+  if (position == set->index.cend()) {
+    return nullptr;
+  }
+  return &_statuses.constFind(key.first)->sessions.at(*position);
+}
+
+void Claude_status_tracker::set_session_state(
+  const Session_key& key,
+  qint64 at_ms,
   Claude_state state,
   const QString& tool_name,
   const QString& wait_reason,
   const QString& wait_message
 ) {
-  auto current = _db.claude_status(workspace);
-  if (current && current->state == state
-    && current->tool_name == tool_name
-    && current->wait_reason == wait_reason
-    && current->wait_message == wait_message)
+  const auto& [workspace, session_id] = key;
+
+  auto set = _session_sets.find(workspace);
+  if (set == _session_sets.end() || !set->index.contains(session_id)) {
+    add_session(key, Claude_session_status{
+      .session_id = session_id,
+      .state = state,
+      .tool_name = tool_name,
+      .wait_reason = wait_reason,
+      .wait_message = wait_message,
+      .state_since_ms = at_ms
+    });
+    return;
+  }
+
+  auto& session = _statuses.find(workspace)->sessions[set->index.value(session_id)];
+  if (session.state == state
+    && session.tool_name == tool_name
+    && session.wait_reason == wait_reason
+    && session.wait_message == wait_message)
+  {
+    return;
+  }
+
+  record_state_time(key, session, state, at_ms);
+  if (state == Claude_state::IDLE || state == Claude_state::REQUESTING) {
+    // Interrupted: the tool never reported back, its time is unknown.
+    _running_tools.remove(key);
+  }
+
+  set->by_state[static_cast< size_t>(session.state)].remove(session_id);
+  set->by_state[static_cast< size_t>(state)].insert(session_id);
+  session.state          = state;
+  session.tool_name      = tool_name;
+  session.wait_reason    = wait_reason;
+  session.wait_message   = wait_message;
+  session.state_since_ms = at_ms;
+
+  update_deadline(key, state);
+  arm_timeout_timer();
+
+  // Batches log one summary line instead.
+  if (!_in_batch) {
+    if (!tool_name.isEmpty()) {
+      qCInfo(logClaude, "'%s' session %s -> %s [tool=%s]",
+        qPrintable(workspace), qPrintable(session_id), qPrintable(to_wire_string(state)), qPrintable(tool_name));
+    }
+    else {
+      qCInfo(logClaude, "'%s' session %s -> %s",
+        qPrintable(workspace), qPrintable(session_id), qPrintable(to_wire_string(state)));
+    }
+  }
+
+  update_aggregate(workspace, session_id, at_ms);
+}
+
+void Claude_status_tracker::record_state_time(
+  const Session_key& key,
+  const Claude_session_status& session,
+  Claude_state state,
+  qint64 now
+) {
+  auto elapsed = now - session.state_since_ms;
+  if (session.state == Claude_state::WAITING && state != Claude_state::WAITING) {
+    _timings[key.first].waiting_ms.record(elapsed);
+    // Time blocked on the user is not tool time.
+    auto tool = _running_tools.find(key);
+    if (tool != _running_tools.end()) {
+      tool->started_ms += elapsed;
+    }
+  }
+  else if (session.state == Claude_state::REQUESTING && state == Claude_state::WORKING) {
+    _timings[key.first].first_tool_ms.record(elapsed);
+  }
+}
+
+void Claude_status_tracker::start_tool(const Session_key& key, const QString& tool_name, qint64 now) {
+  // Parallel tool calls carry no id to pair Pre with PostToolUse; a new
+  // PreToolUse ends the previous tool of the session.
+  finish_tool(key, now);
+  _running_tools.insert(key, Running_tool{tool_name, now});
+}
+
+void Claude_status_tracker::finish_tool(const Session_key& key, qint64 now) {
+  auto tool = _running_tools.find(key);
+  if (tool == _running_tools.end()) {
+    return;
+  }
+  _timings[key.first].tool_ms[tool->name].record(now - tool->started_ms);
+  _running_tools.erase(tool);
+}
+
+void Claude_status_tracker::reset_timings() {
+  _timings.clear();
+  qCInfo(logClaude, "timing histograms reset");
+}
+
+void Claude_status_tracker::add_session(const Session_key& key, const Claude_session_status& session) {
+  const auto& [workspace, session_id] = key;
+
+  auto it = _statuses.find(workspace);
+  if (it == _statuses.end()) {
+    it = _statuses.insert(workspace, Claude_workspace_status{.workspace_name = workspace});
+  }
+  auto& set = _session_sets[workspace];
+  set.index.insert(session_id, it->sessions.size());
+  set.by_state[static_cast< size_t>(session.state)].insert(session_id);
+  it->sessions.append(session);
+
+  update_deadline(key, session.state);
+  arm_timeout_timer();
+
+  if (!_in_batch) {
+    qCInfo(logClaude, "'%s' session %s started in %s (%d sessions)",
+      qPrintable(workspace), qPrintable(session_id), qPrintable(to_wire_string(session.state)),
+      static_cast< int>(it->sessions.size()));
+  }
+
+  update_aggregate(workspace, session_id, session.state_since_ms);
+}
+
+void Claude_status_tracker::remove_session(const Session_key& key, qint64 at_ms) {
+  const auto& [workspace, session_id] = key;
+
+  auto set = _session_sets.find(workspace);
+  if (set == _session_sets.end() || !set->index.contains(session_id)) {
+    return;
+  }
+
+  // Swap with the last session so removal stays O(1).
+  auto& sessions = _statuses.find(workspace)->sessions;
+  auto position = set->index.take(session_id);
+  set->by_state[static_cast< size_t>(sessions.at(position).state)].remove(session_id);
+  if (position != sessions.size() - 1) {
+    sessions[position] = sessions.last();
+    set->index.insert(sessions.at(position).session_id, position);
+  }
+  sessions.removeLast();
+
+  _running_tools.remove(key);
+  _processes.unwatch(workspace, session_id);
+  update_deadline(key, Claude_state::NOT_RUNNING);
+  arm_timeout_timer();
+
+  if (!_in_batch) {
+    qCInfo(logClaude, "'%s' session %s ended (%d left)",
+      qPrintable(workspace), qPrintable(session_id), static_cast< int>(sessions.size()));
+  }
+
+  update_aggregate(workspace, {}, at_ms);
+}
+
+void Claude_status_tracker::update_aggregate(
+  const QString& workspace, const QString& changed_session, qint64 at_ms
+) {
+  auto it = _statuses.find(workspace);
+  const auto& set = *_session_sets.constFind(workspace);
+  ++_stats.changes;
+
+  if (it->sessions.isEmpty()) {
+    auto since = _db.end_claude_session(workspace, at_ms);
+    _statuses.erase(it);
+    _session_sets.remove(workspace);
+    notify(Claude_workspace_status{
+      .workspace_name = workspace,
+      .state = Claude_state::NOT_RUNNING,
+      .state_since_ms = since
+    });
+    return;
+  }
+
+  auto state = Claude_state::IDLE;
+  for (auto candidate : _precedence) {
+    if (!set.by_state[static_cast< size_t>(candidate)].isEmpty()) {
+      state = candidate;
+      break;
+    }
+  }
+
+  // The session deciding the aggregate: the one that just changed if it
+  // is in the winning state, else the previous one if it still is, else any.
+  const auto& members = set.by_state[static_cast< size_t>(state)];
+  auto lead = members.contains(changed_session) ? changed_session
+    : members.contains(it->session_id) ? it->session_id
+    : *members.cbegin();
+  const auto& session = it->sessions.at(set.index.value(lead));
+
+  bool first_session = it->state == Claude_state::NOT_RUNNING;
+  if (!first_session
+    && it->state == state
+    && it->tool_name == session.tool_name
+    && it->wait_reason == session.wait_reason
+    && it->wait_message == session.wait_message)
   {
+    // Same aggregate; only the breakdown changed.
+    it->session_id = lead;
+    notify(*it);
     return;
   }
 
-  auto since = _db.set_claude_state(workspace, state, tool_name, wait_reason, wait_message);
-  if (since < 0) {
+  qint64 since = 0;
+  if (first_session) {
+    since = _db.start_claude_session(workspace, lead, at_ms);
+  }
+  if (!first_session || state != Claude_state::IDLE) {
+    since = _db.set_claude_state(workspace, state,
+      session.tool_name, session.wait_reason, session.wait_message, at_ms);
+  }
+
+  it->state          = state;
+  it->tool_name      = session.tool_name;
+  it->wait_reason    = session.wait_reason;
+  it->wait_message   = session.wait_message;
+  it->state_since_ms = since;
+  it->session_id     = lead;
+
+  notify(*it);
+}
+
+void Claude_status_tracker::notify(const Claude_workspace_status& status) {
+  if (_in_batch) {
+    if (!_batch_changes.contains(status.workspace_name)) {
+      _batch_order.append(status.workspace_name);
+    }
+    _batch_changes.insert(status.workspace_name, status);
     return;
   }
 
-  if (!tool_name.isEmpty()) {
-    qCInfo(logClaude, "'%s' -> %s [tool=%s]",
-      qPrintable(workspace), qPrintable(to_wire_string(state)), qPrintable(tool_name));
+  emit status_changed(status);
+}
+
+void Claude_status_tracker::update_deadline(const Session_key& key, Claude_state state) {
+  if ((state != Claude_state::WORKING && state != Claude_state::REQUESTING)
+    || _processes.is_watching(key.first, key.second))
+  {
+    _deadlines.remove(key);
+    return;
   }
-  else {
-    qCInfo(logClaude, "'%s' -> %s", qPrintable(workspace), qPrintable(to_wire_string(state)));
+
+  auto timeout_ms = std::chrono::duration_cast< std::chrono::milliseconds>(_working_timeout).count();
+  // Client clocks may be skewed, and a held event is applied up to the
+  // reorder window late; either would shift a client-time deadline.
+  auto deadline = QDateTime::currentMSecsSinceEpoch() + timeout_ms;
+  _deadlines.insert(key, deadline);
+  _deadline_heap.emplace(deadline, key);
+
+  // Every PostToolUse pushes a new entry; rebuild once stale ones dominate.
+  if (_deadline_heap.size() > 64 && _deadline_heap.size() > 4 * static_cast< size_t>(_deadlines.size())) {
+    std::vector< Deadline> live;
+    live.reserve(_deadlines.size());
+    for (auto it = _deadlines.cbegin(); it != _deadlines.cend(); ++it) {
+      live.emplace_back(it.value(), it.key());
+    }
+    _deadline_heap = decltype(_deadline_heap)(std::greater< Deadline>(), std::move(live));
   }
+}
 
-  emit status_changed(workspace, state, tool_name, wait_reason, wait_message, since);
+void Claude_status_tracker::arm_timeout_timer() {
+  while (!_deadline_heap.empty()) {
+    const auto& [deadline, key] = _deadline_heap.top();
+    auto it = _deadlines.constFind(key);
+    if (it != _deadlines.cend() && it.value() == deadline) {
+      break;
+    }
+    _deadline_heap.pop();
+  }
+
+  if (_deadline_heap.empty()) {
+    _timeout_timer.stop();
+    return;
+  }
+
+  auto delay_ms = _deadline_heap.top().first - QDateTime::currentMSecsSinceEpoch();
+  _timeout_timer.start(std::chrono::milliseconds(std::max< qint64>(delay_ms, 0)));
 }
 
 void Claude_status_tracker::check_timeouts() {
   auto now = QDateTime::currentMSecsSinceEpoch();
-  auto timeout_ms = std::chrono::duration_cast< std::chrono::milliseconds>(_working_timeout).count();
 
-  auto statuses = _db.all_claude_statuses();
-  for (const auto& status : statuses) {
-    if ((status.state == Claude_state::WORKING || status.state == Claude_state::REQUESTING)
-      && (now - status.state_since_ms) > timeout_ms
-    ) {
-      qCWarning(logClaude, "workspace '%s' %s timeout (%" PRId64 " min), resetting to IDLE",
-        qPrintable(status.workspace_name),
-        qPrintable(to_wire_string(status.state)),
-        static_cast< int64_t>(std::chrono::duration_cast< std::chrono::minutes>(_working_timeout).count()));
-      set_state(status.workspace_name, Claude_state::IDLE);
+  // set_session_state() drops the deadline and re-arms the timer for the next one.
+  while (!_deadline_heap.empty() && _deadline_heap.top().first <= now) {
+    auto [deadline, key] = _deadline_heap.top();
+    _deadline_heap.pop();
+
+    auto it = _deadlines.constFind(key);
+    if (it == _deadlines.cend() || it.value() != deadline) {
+      continue;
     }
+
+    auto* session = find_session(key);
+    qCWarning(logClaude, "workspace '%s' session %s %s timeout (%" PRId64 " min), resetting to IDLE",
+      qPrintable(key.first), qPrintable(key.second),
+      qPrintable(to_wire_string(session ? session->state : Claude_state::NOT_RUNNING)),
+      static_cast< int64_t>(std::chrono::duration_cast< std::chrono::minutes>(_working_timeout).count()));
+    set_session_state(key, now, Claude_state::IDLE);
+    _deadlines.remove(key);
   }
+
+  arm_timeout_timer();
 }
@@ -1,63 +1,218 @@
 #pragma once
 
+#include "claude_event_reorder.h"
+#include "claude_process_monitor.h"
+#include "claude_event_types.h"
+#include "latency_histogram.h"
+
 #include <claude_types.h>
 
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QString>
 #include <QTimer>
 #include <QVector>
 
+#include <array>
 #include <chrono>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+class Workspace_storage;
+
+/// Per-event processing cost of Claude_status_tracker::process_event().
+struct Claude_tracker_stats {
+  qint64 events = 0;
+  qint64 changes = 0;     ///< events that changed a workspace state or its sessions
+  qint64 total_ns = 0;
+  qint64 max_ns = 0;
+  qint64 stale = 0;       ///< timestamped events dropped as older than one applied
+};
 
-class Workspace_db;
+/// Timing histograms of one workspace, accumulated over its sessions.
+struct Claude_workspace_timings {
+  /// PreToolUse to PostToolUse per tool name, without time spent WAITING.
+  QHash< QString, Latency_histogram> tool_ms;
+  Latency_histogram first_tool_ms;  ///< Prompt submitted (REQUESTING) to the first tool
+  Latency_histogram waiting_ms;     ///< Blocked on the user (WAITING)
+};
 
-/// Tracks Claude Code status per workspace via a simple state machine.
+/// Tracks Claude Code status per session via a simple state machine.
 /// Events arrive from hook scripts through the status socket server.
-/// Persists state to the database via Workspace_db.
+/// A workspace may run several sessions (parallel agents, subagents); its
+/// state is their aggregate, WAITING > WORKING > REQUESTING > IDLE,
+/// updated from per-state session sets on each event.
+/// The state machine runs in memory; only changes of a workspace's
+/// aggregate are handed to Workspace_storage, which persists them in the
+/// background. Sessions themselves are not persisted: on startup each
+/// workspace resumes with one session holding its stored state, which
+/// stands in until the workspace's first event names a real session.
+/// A SessionStart that carries the agent's PID puts the session under
+/// Claude_process_monitor, which ends it when the process exits. Only
+/// sessions without one (older hooks, restored sessions) fall back to the
+/// WORKING/REQUESTING timeout.
 class Claude_status_tracker : public QObject {
   Q_OBJECT
 
  public:
-  explicit Claude_status_tracker(Workspace_db& db, QObject* parent = nullptr);
+  explicit Claude_status_tracker(Workspace_storage& db, QObject* parent = nullptr);
 
+  /// @p event_type in wire format ("working", "stop", ...), as sent over D-Bus.
   void process_event(
     const QString& workspace,
     const QString& event_type,
     const QStringList& args
   );
 
+  /// @p client_ts_ms, when the client saw the event (epoch ms), orders the
+  /// session's events through the reorder window and becomes the
+  /// state_since_ms of the state it enters. 0 applies the event at once,
+  /// at the daemon's time.
+  void process_event(
+    const QString& workspace,
+    Claude_event event,
+    const QStringList& args,
+    qint64 client_ts_ms = 0
+  );
+
+  /// Process an event reported for a working directory, in the workspace
+  /// whose project_dir contains @p path (resolved through the storage path
+  /// index and its per-path cache). @return false if no workspace matches
+  /// and the event was dropped.
+  bool process_event_for_path(
+    const QString& path,
+    Claude_event event,
+    const QStringList& args,
+    qint64 client_ts_ms = 0
+  );
+
+  /// Apply @p events as one unit: their state changes are persisted in one
+  /// storage transaction and status_changed is emitted once per affected
+  /// workspace, with its final state, after the batch. Timestamped events
+  /// go in client time order per session, with any still held in the
+  /// reorder window; stale ones are dropped.
+  void process_events(const QVector< Claude_reported_event>& events);
+
   QVector< Claude_workspace_status> all_statuses() const;
 
+  const Claude_tracker_stats& stats() const { return _stats; }
+
+  /// Per-workspace timing histograms since start or the last reset_timings().
+  const QHash< QString, Claude_workspace_timings>& timings() const { return _timings; }
+  void reset_timings();
+
  signals:
-  void status_changed(
-    const QString& workspace,
-    Claude_state state,
-    const QString& tool_name,
-    const QString& wait_reason,
-    const QString& wait_message,
-    qint64 state_since_ms
-  );
+  /// A workspace's aggregate state or its session breakdown changed.
+  void status_changed(const Claude_workspace_status& status);
 
  private:
-  void handle_session_start(const QString& workspace, const QStringList& args);
-  void handle_prompt_submit(const QString& workspace, const QStringList& args);
-  void handle_working(const QString& workspace, const QStringList& args);
-  void handle_post_tool(const QString& workspace, const QStringList& args);
-  void handle_stop(const QString& workspace, const QStringList& args);
-  void handle_notification(const QString& workspace, const QStringList& args);
-  void handle_session_end(const QString& workspace, const QStringList& args);
-
-  void set_state(
-    const QString& workspace,
+  /// Run one event through the state machine at @p at_ms and account its cost.
+  void apply_event(const QString& workspace, Claude_event event, const QStringList& args, qint64 at_ms);
+
+  /// Workspace name and session id.
+  using Session_key = std::pair< QString, QString>;
+
+  void handle_session_start(const Session_key& key, const QStringList& args, qint64 at_ms);
+  void handle_prompt_submit(const Session_key& key, const QStringList& args, qint64 at_ms);
+  void handle_working(const Session_key& key, const QStringList& args, qint64 at_ms);
+  void handle_post_tool(const Session_key& key, const QStringList& args, qint64 at_ms);
+  void handle_stop(const Session_key& key, const QStringList& args, qint64 at_ms);
+  void handle_notification(const Session_key& key, const QStringList& args, qint64 at_ms);
+  void handle_session_end(const Session_key& key, const QStringList& args, qint64 at_ms);
+
+  /// End a session whose agent process exited, through the reorder window
+  /// so its held events still apply first and late ones are dropped.
+  void on_process_exited(const QString& workspace, const QString& session_id, qint64 pid);
+
+  /// Sessions of one workspace. Positions index the workspace's
+  /// Claude_workspace_status::sessions; by_state holds the session ids in
+  /// each Claude_state, so the aggregate never needs a rescan.
+  struct Session_set {
+    QHash< QString, int> index;
+    std::array< QSet< QString>, static_cast< size_t>(Claude_state::WAITING) + 1> by_state;
+  };
+
+  /// The workspace's only session, for events from clients that do not
+  /// name one. Empty if it has none or several.
+  QString sole_session(const QString& workspace) const;
+  const Claude_session_status* find_session(const Session_key& key) const;
+
+  /// Move a session to @p state at @p at_ms, creating it if unknown.
+  void set_session_state(
+    const Session_key& key,
+    qint64 at_ms,
     Claude_state state,
     const QString& tool_name = {},
     const QString& wait_reason = {},
     const QString& wait_message = {}
   );
+  /// Account time spent in the state @p session leaves for @p state.
+  void record_state_time(const Session_key& key, const Claude_session_status& session, Claude_state state, qint64 now);
+  /// End the session's running tool, if any, and start @p tool_name.
+  void start_tool(const Session_key& key, const QString& tool_name, qint64 now);
+  /// Record the session's running tool, if any, as finished at @p now.
+  void finish_tool(const Session_key& key, qint64 now);
+
+  void add_session(const Session_key& key, const Claude_session_status& session);
+  void remove_session(const Session_key& key, qint64 at_ms);
+  /// Recompute the workspace aggregate after a change of @p changed_session
+  /// at @p at_ms and persist it if it differs; notify the new breakdown either way.
+  void update_aggregate(const QString& workspace, const QString& changed_session, qint64 at_ms);
+
+  /// Record activity of a session in @p state: WORKING and REQUESTING
+  /// (re)start the timeout deadline, any other state drops it. Deadlines
+  /// run from the daemon's clock, not the client time the event carries.
+  /// Sessions with a watched agent process get no deadline.
+  void update_deadline(const Session_key& key, Claude_state state);
+  /// Arm _timeout_timer for the earliest live deadline, stop it if none.
+  void arm_timeout_timer();
   void check_timeouts();
 
-  Workspace_db& _db;
+  /// Emit status_changed, or record it for the end of the current batch.
+  void notify(const Claude_workspace_status& status);
+
+  using Deadline = std::pair< qint64, Session_key>;
+
+  struct Running_tool {
+    QString name;
+    qint64 started_ms = 0;  ///< Moved forward by time spent WAITING
+  };
+
+  /// Aggregation order, highest first.
+  static constexpr std::array< Claude_state, 4> _precedence = {
+    Claude_state::WAITING, Claude_state::WORKING, Claude_state::REQUESTING, Claude_state::IDLE
+  };
+
+  Workspace_storage& _db;
+  /// Current status per workspace with a session; NOT_RUNNING ones are dropped.
+  QHash< QString, Claude_workspace_status> _statuses;
+  QHash< QString, Session_set> _session_sets;
+  /// Session restored from storage per workspace, until its first event.
+  QHash< QString, QString> _restored_sessions;
+  Claude_tracker_stats _stats;
+  QHash< QString, Claude_workspace_timings> _timings;
+  /// Tool between its PreToolUse and PostToolUse, per session.
+  QHash< Session_key, Running_tool> _running_tools;
+
+  bool _in_batch = false;
+  /// Last change per workspace within the current batch, in first-change order.
+  QHash< QString, Claude_workspace_status> _batch_changes;
+  QStringList _batch_order;
   QTimer _timeout_timer;
+  Claude_event_reorder _reorder;
+  Claude_process_monitor _processes;
+
+  /// Live deadline (epoch ms) per session; the heap may also hold stale
+  /// entries for superseded deadlines, skipped when they reach the top.
+  QHash< Session_key, qint64> _deadlines;
+  std::priority_queue< Deadline, std::vector< Deadline>, std::greater< Deadline>> _deadline_heap;
 
+  /// Only for sessions without a watched agent process.
   static constexpr auto _working_timeout = std::chrono::minutes(5);
+  /// How long timestamped events wait for earlier-stamped ones of their
+  /// session; hook processes started in order can arrive this far apart.
+  static constexpr auto _reorder_window = std::chrono::milliseconds(50);
 };
@@ -0,0 +1,84 @@
+#include "db_reader_pool.h"
+#include "journal_log.h"
+
+#include <QSqlError>
+
+Db_reader_pool::Db_reader_pool(const QString& db_path, const QString& connection_prefix, int size)
+  : _db_path(db_path)
+  , _connection_prefix(connection_prefix)
+  , _size(size)
+{
+}
+
+Db_reader_pool::~Db_reader_pool() {
+  {
+    std::lock_guard lock(_mutex);
+    _stopping = true;
+  }
+  _not_empty.notify_all();
+
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+void Db_reader_pool::start(Query setup, Query teardown) {
+  _setup = std::move(setup);
+  _teardown = std::move(teardown);
+
+  _threads.reserve(_size);
+  for (int worker = 0; worker < _size; ++worker) {
+    _threads.emplace_back(&Db_reader_pool::run, this, worker);
+  }
+}
+
+bool Db_reader_pool::submit(Query query) {
+  if (_threads.empty()) {
+    return false;
+  }
+
+  {
+    std::lock_guard lock(_mutex);
+    _queue.push_back(std::move(query));
+  }
+  _not_empty.notify_one();
+  return true;
+}
+
+void Db_reader_pool::run(int worker) {
+  auto connection_name = QString("%1_%2").arg(_connection_prefix).arg(worker);
+  {
+    auto db = QSqlDatabase::addDatabase("QSQLITE", connection_name);
+    db.setDatabaseName(_db_path);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+    if (db.open()) {
+      _setup(db, worker);
+    }
+    else {
+      qCCritical(logServer, "db reader %d: failed to open database '%s': %s",
+        worker, qPrintable(_db_path), qPrintable(db.lastError().text()));
+    }
+
+    for (;;) {
+      Query query;
+      {
+        std::unique_lock lock(_mutex);
+        _not_empty.wait(lock, [this] { return _stopping || !_queue.empty(); });
+        if (_queue.empty()) {
+          break;
+        }
+        query = std::move(_queue.front());
+        _queue.pop_front();
+      }
+
+      // Queries run even on a closed connection: they fail through their
+      // own error path and still deliver a reply.
+      query(db, worker);
+    }
+
+    _teardown(db, worker);
+    db.close();
+  }
+  QSqlDatabase::removeDatabase(connection_name);
+}
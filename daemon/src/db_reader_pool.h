@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QSqlDatabase>
+#include <QString>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed set of worker threads, each with its own read-only SQLite
+/// connection. In WAL mode readers never block the writer or each other,
+/// so queries submitted here run concurrently with Db_writer and off the
+/// GUI thread.
+class Db_reader_pool {
+ public:
+  /// Function executed on a worker thread with that worker's connection.
+  /// @p worker is the worker index in [0, size()).
+  using Query = std::function< void(QSqlDatabase& db, int worker)>;
+
+  /// Connections are named "<connection_prefix>_<worker>".
+  Db_reader_pool(const QString& db_path, const QString& connection_prefix, int size);
+
+  /// Finishes queued queries, closes the connections and joins the workers.
+  ~Db_reader_pool();
+
+  Db_reader_pool(const Db_reader_pool&) = delete;
+  Db_reader_pool& operator =(const Db_reader_pool&) = delete;
+
+  /// Start the workers. @p setup runs first on every worker connection,
+  /// @p teardown last, before the connection is closed.
+  void start(Query setup, Query teardown);
+
+  /// Enqueue @p query for the next idle worker.
+  /// @return false if the pool was never started and @p query was dropped.
+  bool submit(Query query);
+
+  int size() const { return _size; }
+
+ private:
+  void run(int worker);
+
+  QString _db_path;
+  QString _connection_prefix;
+  int _size;
+  Query _setup;
+  Query _teardown;
+
+  std::mutex _mutex;
+  std::condition_variable _not_empty;
+  std::deque< Query> _queue;
+  bool _stopping = false;
+
+  std::vector< std::thread> _threads;
+};
@@ -0,0 +1,141 @@
+#include "db_writer.h"
+#include "journal_log.h"
+
+#include <QSqlError>
+
+#include <algorithm>
+#include <cinttypes>
+
+Db_writer::Db_writer(const QString& db_path, const QString& connection_name, std::size_t capacity)
+  : _db_path(db_path)
+  , _connection_name(connection_name)
+{
+  _stats.capacity = capacity;
+}
+
+Db_writer::~Db_writer() {
+  if (!_thread.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard lock(_mutex);
+    _stopping = true;
+  }
+  _not_empty.notify_one();
+  _thread.join();
+}
+
+void Db_writer::start(Command setup) {
+  _thread = std::thread(&Db_writer::run, this, std::move(setup));
+}
+
+void Db_writer::submit(const char* name, Command command) {
+  if (!_thread.joinable()) {
+    // Never started (database failed to open): nothing would drain the queue.
+    return;
+  }
+
+  {
+    std::unique_lock lock(_mutex);
+    if (_queue.size() >= _stats.capacity) {
+      ++_stats.blocked_submits;
+      qCWarning(logServer, "db writer: queue full (%zu commands), '%s' waits for space",
+        _queue.size(), name);
+      _not_full.wait(lock, [this] { return _queue.size() < _stats.capacity; });
+    }
+
+    _last_submit = std::chrono::steady_clock::now();
+    _queue.push_back({name, std::move(command), _last_submit});
+    ++_submitted;
+    _stats.depth = _queue.size();
+    _stats.max_depth = std::max(_stats.max_depth, _stats.depth);
+  }
+  _not_empty.notify_one();
+}
+
+void Db_writer::flush() {
+  wait_for(submitted());
+}
+
+std::uint64_t Db_writer::submitted() const {
+  std::lock_guard lock(_mutex);
+  return _submitted;
+}
+
+void Db_writer::wait_for(std::uint64_t count) {
+  if (!_thread.joinable()) {
+    return;
+  }
+
+  std::unique_lock lock(_mutex);
+  _drained.wait(lock, [this, count] { return _stats.executed >= count; });
+}
+
+std::chrono::steady_clock::duration Db_writer::idle_for() const {
+  std::lock_guard lock(_mutex);
+  if (_stats.executed < _submitted) {
+    return {};
+  }
+  return std::chrono::steady_clock::now() - _last_submit;
+}
+
+Db_writer_stats Db_writer::stats() const {
+  std::lock_guard lock(_mutex);
+  return _stats;
+}
+
+void Db_writer::run(Command setup) {
+  {
+    auto db = QSqlDatabase::addDatabase("QSQLITE", _connection_name);
+    db.setDatabaseName(_db_path);
+
+    if (db.open()) {
+      setup(db);
+    }
+    else {
+      qCCritical(logServer, "db writer: failed to open database '%s': %s",
+        qPrintable(_db_path), qPrintable(db.lastError().text()));
+    }
+
+    for (;;) {
+      Queued_command item;
+      {
+        std::unique_lock lock(_mutex);
+        _not_empty.wait(lock, [this] { return _stopping || !_queue.empty(); });
+        if (_queue.empty()) {
+          break;
+        }
+        item = std::move(_queue.front());
+        _queue.pop_front();
+        _stats.depth = _queue.size();
+      }
+      _not_full.notify_one();
+
+      auto started = std::chrono::steady_clock::now();
+      if (db.isOpen()) {
+        item.command(db);
+      }
+      auto finished = std::chrono::steady_clock::now();
+
+      if (finished - started > _slow_command) {
+        qCWarning(logServer, "db writer: '%s' took %" PRId64 " ms", item.name,
+          static_cast< int64_t>(std::chrono::duration_cast< std::chrono::milliseconds>(finished - started).count()));
+      }
+
+      auto latency_us = std::chrono::duration_cast< std::chrono::microseconds>(
+        finished - item.submitted).count();
+      {
+        std::lock_guard lock(_mutex);
+        ++_stats.executed;
+        _stats.last_latency_us = latency_us;
+        _stats.max_latency_us = std::max< std::int64_t>(_stats.max_latency_us, latency_us);
+        _stats.total_latency_us += latency_us;
+      }
+      _drained.notify_all();
+    }
+
+    db.close();
+  }
+  QSqlDatabase::removeDatabase(_connection_name);
+}
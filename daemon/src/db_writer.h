@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QSqlDatabase>
+#include <QString>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/// Queue and latency counters of a Db_writer, see Db_writer::stats().
+struct Db_writer_stats {
+  std::size_t depth = 0;            ///< Commands waiting in the queue
+  std::size_t max_depth = 0;        ///< High-water mark of depth
+  std::size_t capacity = 0;         ///< Queue bound; submit() blocks when reached
+  std::uint64_t executed = 0;       ///< Commands completed since start
+  std::uint64_t blocked_submits = 0;  ///< submit() calls that had to wait for space
+  std::int64_t last_latency_us = 0;   ///< Submit-to-completion time of the last command
+  std::int64_t max_latency_us = 0;
+  std::int64_t total_latency_us = 0;
+};
+
+/// Dedicated SQLite writer thread with its own connection.
+/// Writes are submitted as command objects to a bounded FIFO queue and
+/// executed in order on the writer thread. A full queue blocks the submitter
+/// (backpressure) instead of growing without bound.
+class Db_writer {
+ public:
+  /// Function executed on the writer thread with the writer connection.
+  using Command = std::function< void(QSqlDatabase& db)>;
+
+  Db_writer(const QString& db_path, const QString& connection_name, std::size_t capacity);
+
+  /// Drains the queue, closes the connection and joins the thread.
+  ~Db_writer();
+
+  Db_writer(const Db_writer&) = delete;
+  Db_writer& operator =(const Db_writer&) = delete;
+
+  /// Open the writer connection and run @p setup on it (pragmas, prepared
+  /// statements) before any submitted command.
+  void start(Command setup);
+
+  /// Enqueue @p command. @p name identifies it in slow-command warnings.
+  void submit(const char* name, Command command);
+
+  /// Barrier: block until every command submitted before this call has finished.
+  void flush();
+
+  /// Number of commands submitted so far. Passing the value to wait_for()
+  /// from any thread waits for exactly those commands (read-your-writes).
+  std::uint64_t submitted() const;
+
+  /// Block until the first @p count submitted commands have finished.
+  void wait_for(std::uint64_t count);
+
+  /// Time since the last submit() (or since construction), zero while
+  /// commands are still queued or running.
+  std::chrono::steady_clock::duration idle_for() const;
+
+  Db_writer_stats stats() const;
+
+ private:
+  struct Queued_command {
+    const char* name = nullptr;
+    Command command;
+    std::chrono::steady_clock::time_point submitted;
+  };
+
+  void run(Command setup);
+
+  QString _db_path;
+  QString _connection_name;
+
+  mutable std::mutex _mutex;
+  std::condition_variable _not_empty;
+  std::condition_variable _not_full;
+  std::condition_variable _drained;
+  std::deque< Queued_command> _queue;
+  std::uint64_t _submitted = 0;
+  std::chrono::steady_clock::time_point _last_submit = std::chrono::steady_clock::now();
+  bool _stopping = false;
+  Db_writer_stats _stats;
+
+  std::thread _thread;
+
+  static constexpr auto _slow_command = std::chrono::milliseconds(100);
+};
@@ -86,16 +86,21 @@ void Desktop_monitor::on_current_desktop_changed(const QDBusMessage& message) {
   if (args.isEmpty()) {
     return;
   }
-  QString current_id = args[0].toString();
+  set_current_desktop(args[0].toString());
+}
+
+void Desktop_monitor::set_current_desktop(const QString& id) {
   for (const auto& desktop : _desktops) {
-    if (desktop.id == current_id) {
-      _current_desktop_name = desktop.name;
-      emit desktops_changed();
+    if (desktop.id == id) {
+      if (_current_desktop_name != desktop.name) {
+        _current_desktop_name = desktop.name;
+        emit current_desktop_changed();
+      }
       return;
     }
   }
-  qCWarning(logServer, "Desktop_monitor: currentDesktopChanged for unknown id '%s'",
-    qPrintable(current_id));
+  qCWarning(logServer, "Desktop_monitor: current desktop id '%s' not found in desktops list",
+    qPrintable(id));
 }
 
 void Desktop_monitor::fetch_current_desktop() {
@@ -115,17 +120,7 @@ void Desktop_monitor::fetch_current_desktop() {
         qPrintable(reply.error().message()));
       return;
     }
-    QString current_id = reply.value().variant().toString();
-    for (const auto& desktop : _desktops) {
-      if (desktop.id == current_id) {
-        _current_desktop_name = desktop.name;
-        emit desktops_changed();
-        return;
-      }
-    }
-    qCWarning(logServer, "Desktop_monitor: current desktop id '%s' not found in desktops list",
-      qPrintable(current_id));
-    emit desktops_changed();
+    set_current_desktop(reply.value().variant().toString());
   });
 }
 
@@ -152,8 +147,14 @@ void Desktop_monitor::on_desktops_fetched(QDBusPendingCallWatcher* watcher) {
   }
 
   auto argument = reply.value().variant().value< QDBusArgument>();
-  _desktops = parse_desktops(argument);
-  sort_by_position(_desktops);
-  qCInfo(logServer, "Desktop_monitor: fetched %d desktops", static_cast< int>(_desktops.size()));
+  auto desktops = parse_desktops(argument);
+  sort_by_position(desktops);
+  qCInfo(logServer, "Desktop_monitor: fetched %d desktops", static_cast< int>(desktops.size()));
+
+  if (desktops != _desktops || !_list_fetched) {
+    _desktops = desktops;
+    _list_fetched = true;
+    emit desktop_list_changed();
+  }
   fetch_current_desktop();
 }
@@ -23,7 +23,11 @@ class Desktop_monitor : public QObject {
   void switch_to_desktop_by_name(const QString& name);
 
  signals:
-  void desktops_changed();
+  /// Desktop set, names or positions changed.
+  void desktop_list_changed();
+
+  /// Current desktop switched; the list itself is unchanged.
+  void current_desktop_changed();
 
  private slots:
   void on_desktop_created(const QDBusMessage& message);
@@ -35,7 +39,9 @@ class Desktop_monitor : public QObject {
  private:
   void fetch_desktops();
   void fetch_current_desktop();
+  void set_current_desktop(const QString& id);
 
   QVector< Kwin_desktop> _desktops;
   QString _current_desktop_name;
+  bool _list_fetched = false;
 };
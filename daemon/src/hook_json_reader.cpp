@@ -0,0 +1,306 @@
+#include "hook_json_reader.h"
+
+namespace {
+
+constexpr unsigned replacement_character = 0xFFFD;
+
+bool is_literal_char(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+    || c == '-' || c == '+' || c == '.';
+}
+
+int hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+} // namespace
+
+Hook_json_reader::Hook_json_reader(std::vector< std::string> fields)
+  : _fields(std::move(fields))
+  , _values(_fields.size())
+{
+}
+
+bool Hook_json_reader::feed(std::string_view chunk) {
+  for (char c : chunk) {
+    if (!step(c)) {
+      _state = State::ERROR;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Hook_json_reader::finish() const {
+  return _state == State::DONE || (_state == State::LITERAL && _containers.empty());
+}
+
+bool Hook_json_reader::step(char c) {
+  switch (_state) {
+    case State::FIRST_ELEMENT:
+      if (c == ']') {
+        _containers.pop_back();
+        _keys.pop_back();
+        end_value();
+        return true;
+      }
+      [[fallthrough]];
+
+    case State::VALUE:
+      if (is_whitespace(c)) {
+        return true;
+      }
+      if (c == '{') {
+        _containers.push_back('{');
+        _keys.emplace_back();
+        _state = State::FIRST_KEY;
+      }
+      else if (c == '[') {
+        _containers.push_back('[');
+        _keys.emplace_back();
+        _state = State::FIRST_ELEMENT;
+      }
+      else if (c == '"') {
+        begin_string(false);
+      }
+      else if (is_literal_char(c)) {
+        _state = State::LITERAL;
+      }
+      else {
+        return false;
+      }
+      return true;
+
+    case State::FIRST_KEY:
+      if (c == '}') {
+        _containers.pop_back();
+        _keys.pop_back();
+        end_value();
+        return true;
+      }
+      [[fallthrough]];
+
+    case State::KEY:
+      if (is_whitespace(c)) {
+        return true;
+      }
+      if (c != '"') {
+        return false;
+      }
+      begin_string(true);
+      return true;
+
+    case State::COLON:
+      if (is_whitespace(c)) {
+        return true;
+      }
+      if (c != ':') {
+        return false;
+      }
+      _state = State::VALUE;
+      return true;
+
+    case State::AFTER_VALUE:
+      if (is_whitespace(c)) {
+        return true;
+      }
+      if (c == ',') {
+        _state = _containers.back() == '{' ? State::KEY : State::VALUE;
+        return true;
+      }
+      if ((c == '}' && _containers.back() == '{') || (c == ']' && _containers.back() == '[')) {
+        _containers.pop_back();
+        _keys.pop_back();
+        end_value();
+        return true;
+      }
+      return false;
+
+    case State::STRING:
+      if (c == '"') {
+        end_string();
+        return true;
+      }
+      if (c == '\\') {
+        _state = State::STRING_ESCAPE;
+        return true;
+      }
+      if (static_cast< unsigned char>(c) < 0x20) {
+        return false;
+      }
+      if (_string_target) {
+        if (_high_surrogate) {
+          append_code_point(replacement_character);
+          _high_surrogate = 0;
+        }
+        _string_target->push_back(c);
+      }
+      return true;
+
+    case State::STRING_ESCAPE: {
+      char decoded = 0;
+      switch (c) {
+        case '"':  decoded = '"';  break;
+        case '\\': decoded = '\\'; break;
+        case '/':  decoded = '/';  break;
+        case 'b':  decoded = '\b'; break;
+        case 'f':  decoded = '\f'; break;
+        case 'n':  decoded = '\n'; break;
+        case 'r':  decoded = '\r'; break;
+        case 't':  decoded = '\t'; break;
+        case 'u':
+          _unicode_value = 0;
+          _unicode_digits = 0;
+          _state = State::UNICODE_ESCAPE;
+          return true;
+        default:
+          return false;
+      }
+      if (_string_target) {
+        if (_high_surrogate) {
+          append_code_point(replacement_character);
+          _high_surrogate = 0;
+        }
+        _string_target->push_back(decoded);
+      }
+      _state = State::STRING;
+      return true;
+    }
+
+    case State::UNICODE_ESCAPE: {
+      auto digit = hex_value(c);
+      if (digit < 0) {
+        return false;
+      }
+      _unicode_value = (_unicode_value << 4) | static_cast< unsigned>(digit);
+      if (++_unicode_digits < 4) {
+        return true;
+      }
+      _state = State::STRING;
+      if (!_string_target) {
+        return true;
+      }
+
+      if (_unicode_value >= 0xD800 && _unicode_value <= 0xDBFF) {
+        if (_high_surrogate) {
+          append_code_point(replacement_character);
+        }
+        _high_surrogate = _unicode_value;
+      }
+      else if (_unicode_value >= 0xDC00 && _unicode_value <= 0xDFFF) {
+        if (_high_surrogate) {
+          append_code_point(0x10000 + ((_high_surrogate - 0xD800) << 10) + (_unicode_value - 0xDC00));
+          _high_surrogate = 0;
+        }
+        else {
+          append_code_point(replacement_character);
+        }
+      }
+      else {
+        if (_high_surrogate) {
+          append_code_point(replacement_character);
+          _high_surrogate = 0;
+        }
+        append_code_point(_unicode_value);
+      }
+      return true;
+    }
+
+    case State::LITERAL:
+      if (is_literal_char(c)) {
+        return true;
+      }
+      end_value();
+      return step(c);
+
+    case State::DONE:
+      return is_whitespace(c);
+
+    case State::ERROR:
+      return false;
+  }
+  return false;
+}
+
+void Hook_json_reader::begin_string(bool is_key) {
+  _string_is_key = is_key;
+  _high_surrogate = 0;
+  _state = State::STRING;
+
+  if (is_key) {
+    _key_buffer.clear();
+    _string_target = &_key_buffer;
+    return;
+  }
+
+  _string_target = nullptr;
+  std::string path;
+  for (size_t i = 0; i < _containers.size(); ++i) {
+    if (_containers[i] != '{') {
+      return;
+    }
+    if (i > 0) {
+      path += '.';
+    }
+    path += _keys[i];
+  }
+
+  for (size_t i = 0; i < _fields.size(); ++i) {
+    if (_fields[i] == path) {
+      _values[i].clear();
+      _string_target = &_values[i];
+      return;
+    }
+  }
+}
+
+void Hook_json_reader::end_string() {
+  if (_string_target && _high_surrogate) {
+    append_code_point(replacement_character);
+  }
+  _high_surrogate = 0;
+  _string_target = nullptr;
+
+  if (_string_is_key) {
+    _keys.back() = _key_buffer;
+    _state = State::COLON;
+  }
+  else {
+    end_value();
+  }
+}
+
+void Hook_json_reader::end_value() {
+  _state = _containers.empty() ? State::DONE : State::AFTER_VALUE;
+}
+
+void Hook_json_reader::append_code_point(unsigned code_point) {
+  auto& out = *_string_target;
+  if (code_point < 0x80) {
+    out.push_back(static_cast< char>(code_point));
+  }
+  else if (code_point < 0x800) {
+    out.push_back(static_cast< char>(0xC0 | (code_point >> 6)));
+    out.push_back(static_cast< char>(0x80 | (code_point & 0x3F)));
+  }
+  else if (code_point < 0x10000) {
+    out.push_back(static_cast< char>(0xE0 | (code_point >> 12)));
+    out.push_back(static_cast< char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast< char>(0x80 | (code_point & 0x3F)));
+  }
+  else {
+    out.push_back(static_cast< char>(0xF0 | (code_point >> 18)));
+    out.push_back(static_cast< char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out.push_back(static_cast< char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast< char>(0x80 | (code_point & 0x3F)));
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Incremental JSON scanner that keeps only selected string fields.
+/// Input is fed in arbitrary chunks; everything outside the requested
+/// paths (e.g. multi-megabyte tool_response payloads) is skipped without
+/// being buffered. Plain C++ so the hook client does not load Qt.
+class Hook_json_reader {
+ public:
+  /// @p fields: dotted object paths of string values to capture,
+  /// e.g. "cwd" or "notification.type". Paths through arrays never match.
+  explicit Hook_json_reader(std::vector< std::string> fields);
+
+  /// Consume the next chunk. @return false once the input is malformed.
+  bool feed(std::string_view chunk);
+
+  /// @return true if exactly one complete JSON value was read.
+  bool finish() const;
+
+  /// Decoded value of the field at @p index in the constructor list;
+  /// empty if absent or not a string.
+  const std::string& value(size_t index) const { return _values[index]; }
+
+ private:
+  enum class State {
+    VALUE,           ///< expecting a value
+    FIRST_KEY,       ///< after '{': key or '}'
+    KEY,             ///< after ',' in an object: key
+    COLON,
+    AFTER_VALUE,     ///< expecting ',' or a closing bracket
+    FIRST_ELEMENT,   ///< after '[': value or ']'
+    STRING,
+    STRING_ESCAPE,
+    UNICODE_ESCAPE,
+    LITERAL,         ///< number, true, false, null
+    DONE,
+    ERROR
+  };
+
+  bool step(char c);
+  void begin_string(bool is_key);
+  void end_string();
+  void end_value();
+  void append_code_point(unsigned code_point);
+  bool is_whitespace(char c) const { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+  std::vector< std::string> _fields;
+  std::vector< std::string> _values;
+
+  State _state = State::VALUE;
+  /// Open containers, '{' or '['.
+  std::vector< char> _containers;
+  /// Current key per open object; array levels hold an empty placeholder.
+  std::vector< std::string> _keys;
+
+  bool _string_is_key = false;
+  /// Where the string being read is decoded to; nullptr when skipped.
+  std::string* _string_target = nullptr;
+  std::string _key_buffer;
+  unsigned _unicode_value = 0;
+  int _unicode_digits = 0;
+  unsigned _high_surrogate = 0;
+};
@@ -0,0 +1,66 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+void Latency_histogram::record(int64_t value_ms) {
+  auto value = std::min(static_cast< uint64_t>(std::max< int64_t>(value_ms, 0)), max_value);
+  ++_counts[bucket_index(value)];
+  ++_count;
+  _sum += value;
+  _min = std::min(_min, value);
+  _max = std::max(_max, value);
+}
+
+void Latency_histogram::merge(const Latency_histogram& other) {
+  for (int i = 0; i < bucket_count; ++i) {
+    _counts[i] += other._counts[i];
+  }
+  _count += other._count;
+  _sum += other._sum;
+  _min = std::min(_min, other._min);
+  _max = std::max(_max, other._max);
+}
+
+void Latency_histogram::reset() {
+  *this = Latency_histogram();
+}
+
+uint64_t Latency_histogram::value_at_percentile(double percentile) const {
+  if (_count == 0) {
+    return 0;
+  }
+
+  auto rank = static_cast< uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * _count));
+  rank = std::max< uint64_t>(rank, 1);
+
+  uint64_t seen = 0;
+  for (int i = 0; i < bucket_count; ++i) {
+    seen += _counts[i];
+    if (seen >= rank) {
+      return std::clamp(bucket_upper_bound(i), min(), _max);
+    }
+  }
+  return _max;
+}
+
+int Latency_histogram::bucket_index(uint64_t value) {
+  if (value < static_cast< uint64_t>(sub_bucket_count)) {
+    return static_cast< int>(value);
+  }
+  // The top sub_bucket_bits + 1 bits select the bucket: the leading one
+  // picks the power of two, the rest the sub-bucket within it.
+  int magnitude = 63 - __builtin_clzll(value);
+  int shift = magnitude - sub_bucket_bits;
+  auto sub_bucket = static_cast< int>(value >> shift) - sub_bucket_count;
+  return (shift + 1) * sub_bucket_count + sub_bucket;
+}
+
+uint64_t Latency_histogram::bucket_upper_bound(int index) {
+  if (index < sub_bucket_count) {
+    return static_cast< uint64_t>(index);
+  }
+  int shift = index / sub_bucket_count - 1;
+  auto sub_bucket = static_cast< uint64_t>(index % sub_bucket_count + sub_bucket_count);
+  return ((sub_bucket + 1) << shift) - 1;
+}
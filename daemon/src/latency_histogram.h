@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/// Fixed-size log-linear histogram of durations in milliseconds, in the
+/// manner of HdrHistogram: values below sub_bucket_count are exact, and
+/// each power of two above is split into sub_bucket_count buckets, so a
+/// reported value is within 1/sub_bucket_count of the recorded one.
+/// Values beyond max_value are clamped to it. Recording is O(1) and the
+/// size never changes (about 2 KiB).
+class Latency_histogram {
+ public:
+  static constexpr int sub_bucket_bits = 4;
+  static constexpr int sub_bucket_count = 1 << sub_bucket_bits;
+  static constexpr int value_bits = 32;
+  static constexpr uint64_t max_value = (uint64_t(1) << value_bits) - 1;  ///< ~50 days
+  static constexpr int bucket_count = (value_bits - sub_bucket_bits + 1) * sub_bucket_count;
+
+  /// Negative values (clock steps) count as 0.
+  void record(int64_t value_ms);
+  void merge(const Latency_histogram& other);
+  void reset();
+
+  uint64_t count() const { return _count; }
+  uint64_t min() const { return _count > 0 ? _min : 0; }
+  uint64_t max() const { return _max; }
+  double mean() const { return _count > 0 ? static_cast< double>(_sum) / _count : 0; }
+
+  /// Highest value equivalent to the one at @p percentile (0..100): the
+  /// top of its bucket, bounded by the recorded min and max. 0 if empty.
+  uint64_t value_at_percentile(double percentile) const;
+
+ private:
+  static int bucket_index(uint64_t value);
+  static uint64_t bucket_upper_bound(int index);
+
+  std::array< uint32_t, bucket_count> _counts{};
+  uint64_t _count = 0;
+  uint64_t _sum = 0;
+  uint64_t _min = max_value;
+  uint64_t _max = 0;
+};
@@ -1,9 +1,12 @@
+#include "claude_event_socket.h"
+#include "claude_status_coalescer.h"
 #include "claude_status_dbus.h"
 #include "claude_status_tracker.h"
 #include "daemon_server.h"
 #include "desktop_monitor.h"
 #include "global_shortcut.h"
 #include "journal_log.h"
+#include "memory_storage.h"
 #include "menu_window.h"
 #include "status_overlay.h"
 #include "tab_tracker.h"
@@ -16,6 +19,7 @@
 #include <QStandardPaths>
 
 #include <csignal>
+#include <memory>
 #include <unistd.h>
 
 static int signal_pipe[2];
@@ -42,22 +46,47 @@ int main(int argc, char* argv[]) {
 
   auto data_dir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
     + "/workspace-menu";
-  Workspace_db db(data_dir + "/workspace.db");
+  // WORKSPACE_STORAGE=memory keeps everything in process memory (stress runs
+  // without disk I/O); nothing is persisted and no migration is done.
+  std::unique_ptr< Workspace_storage> storage;
+  if (qEnvironmentVariable("WORKSPACE_STORAGE") == "memory") {
+    qCWarning(logServer, "using in-memory storage, nothing will be persisted");
+    storage = std::make_unique< Memory_storage>();
+  }
+  else {
+    auto sqlite = std::make_unique< Workspace_db>(data_dir + "/workspace.db");
+
+    // Group-commit window for Claude state writes (0 = write every change immediately)
+    bool commit_window_set = false;
+    auto commit_window_ms = qEnvironmentVariableIntValue("WORKSPACE_CLAUDE_COMMIT_MS", &commit_window_set);
+    if (commit_window_set && commit_window_ms >= 0) {
+      sqlite->set_claude_commit_window(std::chrono::milliseconds(commit_window_ms));
+    }
+
+    // One-time migration from file-based config
+    auto config_dir = qEnvironmentVariable("WORKSPACE_DIR");
+    if (config_dir.isEmpty()) {
+      config_dir = QDir::homePath() + "/.config/workspaces";
+    }
+    sqlite->migrate_from_config_dir(config_dir);
 
-  // One-time migration from file-based config
-  auto config_dir = qEnvironmentVariable("WORKSPACE_DIR");
-  if (config_dir.isEmpty()) {
-    config_dir = QDir::homePath() + "/.config/workspaces";
+    storage = std::move(sqlite);
   }
-  db.migrate_from_config_dir(config_dir);
+  auto& db = *storage;
 
   Desktop_monitor desktop_monitor;
   Menu_window window(db, desktop_monitor);
 
   Claude_status_tracker claude_tracker(db);
+  // Status consumers (overlay, D-Bus listeners) see one batch per frame.
+  Claude_status_coalescer claude_coalescer(claude_tracker);
   // Allocated on heap: QDBusAbstractAdaptor re-parents itself to its parent QObject,
   // so Qt object tree owns its lifetime. Stack allocation would cause double-delete.
-  new Claude_status_dbus(claude_tracker);
+  new Claude_status_dbus(claude_tracker, claude_coalescer);
+
+  // Fire-and-forget event ingestion for the native hook client; D-Bus stays available.
+  Claude_event_socket claude_socket(claude_tracker);
+  claude_socket.start();
 
   // Workspace manager D-Bus service (org.workspace.Manager /Manager).
   // Needs a stable QObject as parent for D-Bus object registration.
@@ -66,27 +95,21 @@ int main(int argc, char* argv[]) {
 
   Status_overlay overlay(desktop_monitor, db);
 
-  QObject::connect(&desktop_monitor, &Desktop_monitor::desktops_changed, &app, [&db, &desktop_monitor]() {
+  // Only list changes reach the database; a plain desktop switch does not.
+  QObject::connect(&desktop_monitor, &Desktop_monitor::desktop_list_changed, &app, [&db, &desktop_monitor]() {
     QVector< Desktop_info> infos;
     int index = 0;
-    const auto& current_name = desktop_monitor.current_desktop_name();
     for (const auto& d : desktop_monitor.desktops()) {
-      infos.append({index++, d.name, d.name == current_name});
+      infos.append({index++, d.name});
     }
     db.sync_active_desktops(infos);
   });
 
-  QObject::connect(&claude_tracker, &Claude_status_tracker::status_changed,
-    &overlay, &Status_overlay::on_status_changed);
+  QObject::connect(&claude_coalescer, &Claude_status_coalescer::statuses_changed,
+    &overlay, &Status_overlay::on_statuses_changed);
 
   // Load initial claude statuses into overlay
-  for (const auto& status : claude_tracker.all_statuses()) {
-    overlay.on_status_changed(
-      status.workspace_name, status.state,
-      status.tool_name, status.wait_reason, status.wait_message,
-      status.state_since_ms
-    );
-  }
+  overlay.on_statuses_changed(claude_tracker.all_statuses());
 
   Tab_tracker tab_tracker(db);
   tab_tracker.start();
@@ -0,0 +1,294 @@
+#include "memory_storage.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+
+QJsonObject Memory_storage::storage_stats() const {
+  QJsonObject obj;
+  obj["backend"] = "memory";
+  obj["workspaces"] = static_cast< qint64>(_workspaces.size());
+  obj["claude_sessions"] = static_cast< qint64>(_claude_sessions.size());
+  obj["claude_events"] = _claude_events;
+  obj["tab_versions"] = _tab_versions;
+  return obj;
+}
+
+void Memory_storage::rebuild_order() {
+  _active_order.clear();
+  _saved_order.clear();
+
+  for (auto it = _workspaces.cbegin(); it != _workspaces.cend(); ++it) {
+    (it->is_active ? _active_order : _saved_order).append(it.key());
+  }
+
+  // Same order as Workspace_db: COALESCE(sort_order, desktop_index), NULLs first.
+  auto order_key = [this](const QString& name) {
+    const auto& row = *_workspaces.constFind(name);
+    return row.sort_order ? row.sort_order : row.desktop_index;
+  };
+  std::sort(_active_order.begin(), _active_order.end(),
+    [&order_key](const QString& a, const QString& b) {
+      auto key_a = order_key(a);
+      auto key_b = order_key(b);
+      if (key_a != key_b) {
+        return key_a < key_b;
+      }
+      return a < b;
+    });
+
+  std::sort(_saved_order.begin(), _saved_order.end());
+}
+
+// --- Workspaces ---
+
+void Memory_storage::create_workspace(const QString& name, const QString& project_dir) {
+  auto existed = _workspaces.contains(name);
+  auto& row = _workspaces[name];
+  _path_index.remove(row.project_dir, name);
+  _path_index.insert(project_dir, name);
+  row.project_dir = project_dir;
+  if (!existed) {
+    rebuild_order();
+  }
+}
+
+QString Memory_storage::get_project_dir(const QString& workspace_name) const {
+  auto it = _workspaces.constFind(workspace_name);
+  return it != _workspaces.cend() ? it->project_dir : QString();
+}
+
+QString Memory_storage::find_workspace_by_path(const QString& path) const {
+  return _path_index.find(path);
+}
+
+QJsonArray Memory_storage::all_workspaces() const {
+  QJsonArray result;
+
+  auto append = [this, &result](const QString& name) {
+    const auto& row = *_workspaces.constFind(name);
+    QJsonObject obj;
+    obj["name"] = name;
+    obj["project_dir"] = row.project_dir;
+    obj["is_active"] = row.is_active;
+    obj["tab_count"] = static_cast< int>(row.tabs.size());
+    result.append(obj);
+  };
+
+  for (const auto& name : _active_order) {
+    append(name);
+  }
+  for (const auto& name : _saved_order) {
+    append(name);
+  }
+  return result;
+}
+
+void Memory_storage::sync_active_desktops(const QVector< Desktop_info>& desktops) {
+  QHash< QString, int> incoming;
+  for (const auto& desktop : desktops) {
+    incoming.insert(desktop.name, desktop.index);
+  }
+
+  for (auto it = _workspaces.begin(); it != _workspaces.end(); ++it) {
+    if (it->is_active && !incoming.contains(it.key())) {
+      it->is_active = false;
+      it->desktop_index.reset();
+    }
+  }
+
+  for (auto it = incoming.cbegin(); it != incoming.cend(); ++it) {
+    auto& row = _workspaces[it.key()];
+    row.is_active = true;
+    row.desktop_index = it.value();
+    if (!row.sort_order) {
+      row.sort_order = it.value();
+    }
+  }
+
+  rebuild_order();
+}
+
+QVector< Workspace_info> Memory_storage::active_desktops() const {
+  QVector< Workspace_info> result;
+  result.reserve(_active_order.size());
+  for (const auto& name : _active_order) {
+    result.append({name, _workspaces.constFind(name)->project_dir});
+  }
+  return result;
+}
+
+QVector< Workspace_info> Memory_storage::saved_workspaces() const {
+  QVector< Workspace_info> result;
+  result.reserve(_saved_order.size());
+  for (const auto& name : _saved_order) {
+    result.append({name, _workspaces.constFind(name)->project_dir});
+  }
+  return result;
+}
+
+void Memory_storage::swap_desktop_order(const QString& name_a, const QString& name_b) {
+  auto it_a = _workspaces.find(name_a);
+  auto it_b = _workspaces.find(name_b);
+  if (it_a == _workspaces.end() || it_b == _workspaces.end()) {
+    return;
+  }
+
+  std::swap(it_a->sort_order, it_b->sort_order);
+  rebuild_order();
+}
+
+QString Memory_storage::active_desktop_name_at(int position) const {
+  return _active_order.value(position);
+}
+
+// --- Tabs ---
+
+void Memory_storage::set_tabs(const QString& workspace_name, const QStringList& urls) {
+  auto existed = _workspaces.contains(workspace_name);
+  auto& row = _workspaces[workspace_name];
+  if (!existed) {
+    rebuild_order();
+  }
+  if (existed && row.tabs == urls) {
+    return;
+  }
+
+  row.tabs = urls;
+  row.tab_history.append({QDateTime::currentMSecsSinceEpoch(), urls});
+  if (row.tab_history.size() > _tab_history_max_versions) {
+    row.tab_history.removeFirst();
+  }
+  ++_tab_versions;
+}
+
+QStringList Memory_storage::get_tabs(const QString& workspace_name) const {
+  auto it = _workspaces.constFind(workspace_name);
+  return it != _workspaces.cend() ? it->tabs : QStringList();
+}
+
+void Memory_storage::get_tabs_async(
+  const QString& workspace_name,
+  std::function< void(const QStringList& urls)> done
+) const {
+  done(get_tabs(workspace_name));
+}
+
+std::optional< QStringList> Memory_storage::get_tabs_at(const QString& workspace_name, qint64 ts_ms) const {
+  auto it = _workspaces.constFind(workspace_name);
+  if (it == _workspaces.cend()) {
+    return std::nullopt;
+  }
+
+  // Newest version saved at or before ts_ms.
+  const auto& history = it->tab_history;
+  auto next = std::upper_bound(history.cbegin(), history.cend(), ts_ms,
+    [](qint64 ts, const QPair< qint64, QStringList>& version) {
+      return ts < version.first;
+    });
+  if (next == history.cbegin()) {
+    return std::nullopt;
+  }
+  return std::prev(next)->second;
+}
+
+void Memory_storage::get_tabs_at_async(
+  const QString& workspace_name,
+  qint64 ts_ms,
+  std::function< void(const std::optional< QStringList>& urls)> done
+) const {
+  done(get_tabs_at(workspace_name, ts_ms));
+}
+
+// --- Claude status ---
+
+qint64 Memory_storage::set_claude_state(
+  const QString& workspace,
+  Claude_state state,
+  const QString& tool_name,
+  const QString& wait_reason,
+  const QString& wait_message,
+  qint64 at_ms
+) {
+  if (!_workspaces.contains(workspace)) {
+    _workspaces.insert(workspace, {});
+    rebuild_order();
+  }
+
+  auto now = at_ms > 0 ? at_ms : QDateTime::currentMSecsSinceEpoch();
+
+  auto& status = _claude_sessions[workspace];
+  status.workspace_name = workspace;
+  status.state          = state;
+  status.tool_name      = tool_name;
+  status.wait_reason    = wait_reason;
+  status.wait_message   = wait_message;
+  status.state_since_ms = now;
+  ++_claude_events;
+
+  return now;
+}
+
+qint64 Memory_storage::start_claude_session(const QString& workspace, const QString& session_id, qint64 at_ms) {
+  if (!_workspaces.contains(workspace)) {
+    _workspaces.insert(workspace, {});
+    rebuild_order();
+  }
+
+  auto now = at_ms > 0 ? at_ms : QDateTime::currentMSecsSinceEpoch();
+
+  _claude_sessions[workspace] = Claude_workspace_status{
+    .workspace_name = workspace,
+    .state = Claude_state::IDLE,
+    .state_since_ms = now,
+    .session_id = session_id
+  };
+  ++_claude_events;
+
+  return now;
+}
+
+qint64 Memory_storage::end_claude_session(const QString& workspace, qint64 at_ms) {
+  auto now = at_ms > 0 ? at_ms : QDateTime::currentMSecsSinceEpoch();
+
+  auto it = _claude_sessions.find(workspace);
+  if (it == _claude_sessions.end()) {
+    return now;
+  }
+  *it = Claude_workspace_status{
+    .workspace_name = workspace,
+    .state = Claude_state::NOT_RUNNING,
+    .state_since_ms = now
+  };
+  ++_claude_events;
+
+  return now;
+}
+
+QVector< Claude_workspace_status> Memory_storage::all_claude_statuses() const {
+  QVector< Claude_workspace_status> result;
+  for (const auto& status : _claude_sessions) {
+    if (status.state != Claude_state::NOT_RUNNING) {
+      result.append(status);
+    }
+  }
+  return result;
+}
+
+std::optional< Claude_workspace_status> Memory_storage::claude_status(const QString& workspace) const {
+  auto it = _claude_sessions.constFind(workspace);
+  if (it == _claude_sessions.cend()) {
+    return std::nullopt;
+  }
+  return *it;
+}
+
+// --- Meta ---
+
+QString Memory_storage::get_meta(const QString& key) const {
+  return _meta.value(key);
+}
+
+void Memory_storage::set_meta(const QString& key, const QString& value) {
+  _meta.insert(key, value);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "path_index.h"
+#include "workspace_storage.h"
+
+#include <QHash>
+#include <QPair>
+
+/// Workspace_storage kept entirely in process memory: no disk I/O, no
+/// threads, nothing survives a restart. Meant for stress runs and for
+/// comparing against the SQLite backend with the same components on top.
+/// Async reads complete synchronously on the calling thread.
+class Memory_storage : public Workspace_storage {
+ public:
+  Memory_storage() = default;
+
+  Memory_storage(const Memory_storage&) = delete;
+  Memory_storage& operator =(const Memory_storage&) = delete;
+
+  void flush() override {}
+  QJsonObject storage_stats() const override;
+
+  // --- Workspaces ---
+
+  void create_workspace(const QString& name, const QString& project_dir) override;
+  QString get_project_dir(const QString& workspace_name) const override;
+  QString find_workspace_by_path(const QString& path) const override;
+  QJsonArray all_workspaces() const override;
+  void sync_active_desktops(const QVector< Desktop_info>& desktops) override;
+  QVector< Workspace_info> active_desktops() const override;
+  QVector< Workspace_info> saved_workspaces() const override;
+  void swap_desktop_order(const QString& name_a, const QString& name_b) override;
+  QString active_desktop_name_at(int position) const override;
+
+  // --- Tabs ---
+
+  void set_tabs(const QString& workspace_name, const QStringList& urls) override;
+  QStringList get_tabs(const QString& workspace_name) const override;
+  std::optional< QStringList> get_tabs_at(const QString& workspace_name, qint64 ts_ms) const override;
+  void get_tabs_async(
+    const QString& workspace_name,
+    std::function< void(const QStringList& urls)> done
+  ) const override;
+  void get_tabs_at_async(
+    const QString& workspace_name,
+    qint64 ts_ms,
+    std::function< void(const std::optional< QStringList>& urls)> done
+  ) const override;
+
+  // --- Claude status ---
+
+  qint64 set_claude_state(
+    const QString& workspace,
+    Claude_state state,
+    const QString& tool_name,
+    const QString& wait_reason,
+    const QString& wait_message,
+    qint64 at_ms
+  ) override;
+  qint64 start_claude_session(const QString& workspace, const QString& session_id, qint64 at_ms) override;
+  qint64 end_claude_session(const QString& workspace, qint64 at_ms) override;
+  void begin_claude_batch() override {}
+  void end_claude_batch() override {}
+  QVector< Claude_workspace_status> all_claude_statuses() const override;
+  std::optional< Claude_workspace_status> claude_status(const QString& workspace) const override;
+
+  // --- Meta ---
+
+  QString get_meta(const QString& key) const override;
+  void set_meta(const QString& key, const QString& value) override;
+
+ private:
+  struct Workspace_row {
+    QString project_dir;
+    bool is_active = false;
+    std::optional< int> desktop_index;
+    std::optional< int> sort_order;
+    QStringList tabs;
+    /// (saved at epoch ms, list) oldest first; lists share data implicitly.
+    QVector< QPair< qint64, QStringList>> tab_history;
+  };
+
+  void rebuild_order();
+
+  static constexpr int _tab_history_max_versions = 1000;
+
+  QHash< QString, Workspace_row> _workspaces;
+  QHash< QString, Claude_workspace_status> _claude_sessions;
+  QHash< QString, QString> _meta;
+  Path_index _path_index;
+
+  QStringList _active_order;
+  QStringList _saved_order;
+
+  qint64 _claude_events = 0;
+  qint64 _tab_versions = 0;
+};
@@ -73,7 +73,7 @@ static QString header_style() {
   ).arg(header_x - 1);  // -1 for list widget 1px margin
 }
 
-Menu_window::Menu_window(Workspace_db& db, Desktop_monitor& desktop_monitor, QWidget* parent)
+Menu_window::Menu_window(Workspace_storage& db, Desktop_monitor& desktop_monitor, QWidget* parent)
   : QWidget(parent)
   , _menu(db, desktop_monitor)
 {
@@ -10,7 +10,7 @@ class QLineEdit;
 class QListWidget;
 class QListWidgetItem;
 class Desktop_monitor;
-class Workspace_db;
+class Workspace_storage;
 
 class Menu_window
   : public QWidget
@@ -19,7 +19,7 @@ class Menu_window
   Q_OBJECT
 
  public:
-  explicit Menu_window(Workspace_db& db, Desktop_monitor& desktop_monitor, QWidget* parent = nullptr);
+  explicit Menu_window(Workspace_storage& db, Desktop_monitor& desktop_monitor, QWidget* parent = nullptr);
 
   void activate(qint64 client_timestamp_ms = 0);
   void cancel_session();
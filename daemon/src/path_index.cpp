@@ -0,0 +1,106 @@
+#include "path_index.h"
+
+#include <algorithm>
+
+Path_index::Path_index(std::size_t cache_capacity)
+  : _nodes(1)
+  , _cache_capacity(cache_capacity)
+{
+}
+
+QStringList Path_index::split(const QString& path) {
+  return path.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+}
+
+void Path_index::insert(const QString& dir, const QString& workspace_name) {
+  if (dir.isEmpty()) {
+    return;
+  }
+
+  int node = 0;
+  for (const auto& component : split(dir)) {
+    auto it = _nodes[node].children.constFind(component);
+    if (it != _nodes[node].children.cend()) {
+      node = *it;
+      continue;
+    }
+    auto child = static_cast< int>(_nodes.size());
+    _nodes[node].children.insert(component, child);
+    _nodes.emplace_back();
+    node = child;
+  }
+
+  auto& workspaces = _nodes[node].workspaces;
+  auto pos = std::lower_bound(workspaces.begin(), workspaces.end(), workspace_name);
+  if (pos == workspaces.end() || *pos != workspace_name) {
+    workspaces.insert(pos, workspace_name);
+  }
+  invalidate_cache();
+}
+
+void Path_index::remove(const QString& dir, const QString& workspace_name) {
+  if (dir.isEmpty()) {
+    return;
+  }
+
+  int node = 0;
+  for (const auto& component : split(dir)) {
+    auto it = _nodes[node].children.constFind(component);
+    if (it == _nodes[node].children.cend()) {
+      return;
+    }
+    node = *it;
+  }
+
+  if (_nodes[node].workspaces.removeOne(workspace_name)) {
+    invalidate_cache();
+  }
+}
+
+void Path_index::clear() {
+  _nodes.assign(1, Node());
+  invalidate_cache();
+}
+
+QString Path_index::find(const QString& path) const {
+  auto cached = _cache_index.constFind(path);
+  if (cached != _cache_index.cend()) {
+    _cache.splice(_cache.begin(), _cache, *cached);
+    return _cache.front().second;
+  }
+
+  auto result = lookup(path);
+
+  if (_cache_capacity == 0) {
+    return result;
+  }
+  if (_cache.size() >= _cache_capacity) {
+    _cache_index.remove(_cache.back().first);
+    _cache.pop_back();
+  }
+  _cache.emplace_front(path, result);
+  _cache_index.insert(path, _cache.begin());
+  return result;
+}
+
+QString Path_index::lookup(const QString& path) const {
+  // Deepest node on the path that has a workspace wins.
+  QString best = _nodes[0].workspaces.value(0);
+  int node = 0;
+  for (const auto& component : split(path)) {
+    auto it = _nodes[node].children.constFind(component);
+    if (it == _nodes[node].children.cend()) {
+      break;
+    }
+    node = *it;
+    if (!_nodes[node].workspaces.isEmpty()) {
+      best = _nodes[node].workspaces.first();
+    }
+  }
+  return best;
+}
+
+void Path_index::invalidate_cache() {
+  _cache.clear();
+  _cache_index.clear();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <cstddef>
+#include <list>
+#include <vector>
+
+/// Longest-prefix index from directory paths to workspace names.
+/// Paths are stored in a trie keyed by path component, so a lookup walks
+/// at most one node per component of the queried path. Recent lookups are
+/// answered from an LRU cache keyed by the exact query string; any change
+/// to the index invalidates the cache.
+class Path_index {
+ public:
+  explicit Path_index(std::size_t cache_capacity = 256);
+
+  /// Register @p workspace_name under directory @p dir.
+  void insert(const QString& dir, const QString& workspace_name);
+
+  /// Unregister @p workspace_name from directory @p dir.
+  void remove(const QString& dir, const QString& workspace_name);
+
+  void clear();
+
+  /// @return workspace whose directory equals @p path or is the closest
+  /// parent of it, empty if none. Several workspaces sharing one directory
+  /// resolve to the smallest name.
+  QString find(const QString& path) const;
+
+ private:
+  struct Node {
+    QHash< QString, int> children;
+    /// Workspaces registered at exactly this directory, sorted.
+    QStringList workspaces;
+  };
+
+  static QStringList split(const QString& path);
+
+  QString lookup(const QString& path) const;
+  void invalidate_cache();
+
+  /// _nodes[0] is the root; children refer to indexes into the vector.
+  /// Nodes are never freed, a removed directory just leaves an empty node.
+  std::vector< Node> _nodes;
+
+  std::size_t _cache_capacity;
+  /// Most recently used query first.
+  mutable std::list< std::pair< QString, QString>> _cache;
+  mutable QHash< QString, std::list< std::pair< QString, QString>>::iterator> _cache_index;
+};
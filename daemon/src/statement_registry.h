@@ -0,0 +1,77 @@
+#pragma once
+
+#include "enum_strings.h"
+#include "journal_log.h"
+
+#include <magic_enum.hpp>
+
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include <array>
+#include <optional>
+
+/// Scoped handle to a cached prepared statement.
+/// Resets the statement on destruction (QSqlQuery::finish -> sqlite3_reset),
+/// so SQLite releases the read cursor and the statement is ready to be re-bound.
+class Prepared_statement {
+ public:
+  explicit Prepared_statement(QSqlQuery& query) : _query(query) {}
+  ~Prepared_statement() { _query.finish(); }
+
+  Prepared_statement(const Prepared_statement&) = delete;
+  Prepared_statement& operator =(const Prepared_statement&) = delete;
+
+  QSqlQuery* operator ->() { return &_query; }
+  QSqlQuery& operator *() { return _query; }
+
+ private:
+  QSqlQuery& _query;
+};
+
+/// Statements of a single connection, compiled once and re-bound per call.
+/// @tparam Id enum listing every statement; each value must be prepared
+/// before it is acquired.
+template< typename Id>
+class Statement_registry {
+ public:
+  /// Compile @p sql as statement @p id on @p db.
+  /// A failed statement stays registered and fails on exec, so callers
+  /// report errors through their usual path.
+  bool prepare(const QSqlDatabase& db, Id id, const QString& sql) {
+    auto& slot = _statements[index(id)];
+    slot.emplace(db);
+    slot->setForwardOnly(true);
+    if (!slot->prepare(sql)) {
+      qCCritical(logServer, "failed to prepare statement '%s': %s",
+        qPrintable(to_wire_string(id)), qPrintable(slot->lastError().text()));
+      return false;
+    }
+    return true;
+  }
+
+  /// Acquire statement @p id for a single bind/exec/read cycle.
+  Prepared_statement acquire(Id id) {
+    auto& slot = _statements[index(id)];
+    if (!slot) {
+      // Connection failed to open: hand out an unbound query that fails on exec.
+      slot.emplace();
+    }
+    return Prepared_statement(*slot);
+  }
+
+  /// Drop all statements. Must be called before the connection is closed.
+  void clear() {
+    for (auto& statement : _statements) {
+      statement.reset();
+    }
+  }
+
+ private:
+  static constexpr std::size_t index(Id id) {
+    return *magic_enum::enum_index(id);
+  }
+
+  std::array< std::optional< QSqlQuery>, magic_enum::enum_count< Id>()> _statements;
+};
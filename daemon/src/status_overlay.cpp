@@ -2,7 +2,7 @@
 #include "desktop_monitor.h"
 #include "enum_strings.h"
 #include "journal_log.h"
-#include "workspace_db.h"
+#include "workspace_storage.h"
 
 #include <QCoreApplication>
 #include <QContextMenuEvent>
@@ -99,7 +99,7 @@ void kwin_set_on_all_desktops(const QString& window_caption) {
 
 Status_overlay::Status_overlay(
   Desktop_monitor& desktop_monitor,
-  Workspace_db& db,
+  Workspace_storage& db,
   QWidget* parent
 )
   : QWidget(parent)
@@ -116,29 +116,17 @@ Status_overlay::Status_overlay(
   setMouseTracking(true);
 
   connect(
-    &_desktop_monitor, &Desktop_monitor::desktops_changed,
+    &_desktop_monitor, &Desktop_monitor::desktop_list_changed,
     this, &Status_overlay::on_desktops_changed
   );
 
   restore_geometry();
 }
 
-void Status_overlay::on_status_changed(
-  const QString& workspace,
-  Claude_state state,
-  const QString& tool_name,
-  const QString& wait_reason,
-  const QString& wait_message,
-  qint64 state_since_ms
-) {
-  _claude_statuses[workspace] = Claude_workspace_status{
-    .workspace_name = workspace,
-    .state = state,
-    .tool_name = tool_name,
-    .wait_reason = wait_reason,
-    .wait_message = wait_message,
-    .state_since_ms = state_since_ms
-  };
+void Status_overlay::on_statuses_changed(const QVector< Claude_workspace_status>& statuses) {
+  for (const auto& status : statuses) {
+    _claude_statuses[status.workspace_name] = status;
+  }
   update_cells();
   update();
 }
@@ -189,6 +177,7 @@ void Status_overlay::update_cells() {
       cell.wait_reason = it->wait_reason;
       cell.wait_message = it->wait_message;
       cell.state_since_ms = it->state_since_ms;
+      cell.sessions = it->sessions;
     }
 
     _cells.append(cell);
@@ -297,6 +286,15 @@ QString Status_overlay::tooltip_text(const Cell_info& cell) const {
       text += "\nDuration: " + QString::number(elapsed / 60) + "m " + QString::number(elapsed % 60) + "s";
   }
 
+  if (cell.sessions.size() > 1) {
+    text += "\nSessions: " + QString::number(cell.sessions.size());
+    for (const auto& session : cell.sessions) {
+      text += "\n  " + session.session_id.left(8) + ": " + to_wire_string(session.state);
+      if (!session.tool_name.isEmpty())
+        text += " [" + session.tool_name + "]";
+    }
+  }
+
   return text;
 }
 
@@ -347,6 +345,16 @@ void Status_overlay::paintEvent(QPaintEvent*) {
     painter.setPen(QColor(state_text_color_hex(_cells[i].state)));
     painter.drawText(rect, Qt::AlignCenter, state_label(_cells[i].state));
 
+    // Session count in the corner when several agents share the workspace.
+    if (_cells[i].sessions.size() > 1) {
+      auto label_font = font;
+      label_font.setPixelSize(qMax(8, static_cast< int>(_cell_size * 0.28)));
+      painter.setFont(label_font);
+      painter.drawText(rect.adjusted(0, 0, -2, 0), Qt::AlignRight | Qt::AlignBottom,
+        QString::number(_cells[i].sessions.size()));
+      painter.setFont(font);
+    }
+
     if (i == _hovered_cell && !_edit_mode) {
       painter.setBrush(Qt::NoBrush);
       painter.setPen(QPen(QColor(255, 255, 255, 160), 2));
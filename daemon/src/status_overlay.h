@@ -8,7 +8,7 @@
 #include <QWidget>
 
 class Desktop_monitor;
-class Workspace_db;
+class Workspace_storage;
 
 /// Frameless sticky overlay widget showing per-workspace Claude Code status
 /// as a grid of colored squares. Has two modes:
@@ -20,19 +20,12 @@ class Status_overlay : public QWidget {
  public:
   Status_overlay(
     Desktop_monitor& desktop_monitor,
-    Workspace_db& db,
+    Workspace_storage& db,
     QWidget* parent = nullptr
   );
 
-  /// Update status for a single workspace.
-  void on_status_changed(
-    const QString& workspace,
-    Claude_state state,
-    const QString& tool_name,
-    const QString& wait_reason,
-    const QString& wait_message,
-    qint64 state_since_ms
-  );
+  /// Update the statuses of the given workspaces, then repaint once.
+  void on_statuses_changed(const QVector< Claude_workspace_status>& statuses);
 
  private slots:
   void on_desktops_changed();
@@ -55,6 +48,7 @@ class Status_overlay : public QWidget {
     QString wait_reason;
     QString wait_message;
     qint64 state_since_ms = 0;
+    QVector< Claude_session_status> sessions;
   };
 
   enum Resize_edge : unsigned {
@@ -78,7 +72,7 @@ class Status_overlay : public QWidget {
   Qt::CursorShape cursor_for_edges(unsigned edges) const;
 
   Desktop_monitor& _desktop_monitor;
-  Workspace_db& _db;
+  Workspace_storage& _db;
 
   QVector< Cell_info> _cells;
   QHash< QString, Claude_workspace_status> _claude_statuses;
@@ -0,0 +1,60 @@
+#include "tab_history.h"
+#include "varint_codec.h"
+
+#include <algorithm>
+
+QByteArray encode_tab_delta(const QVector< qint64>& old_ids, const QVector< qint64>& new_ids) {
+  const int old_size = static_cast< int>(old_ids.size());
+  const int new_size = static_cast< int>(new_ids.size());
+  const int common = std::min(old_size, new_size);
+
+  int prefix = 0;
+  while (prefix < common && old_ids[prefix] == new_ids[prefix]) {
+    ++prefix;
+  }
+
+  int suffix = 0;
+  while (suffix < common - prefix
+    && old_ids[old_size - 1 - suffix] == new_ids[new_size - 1 - suffix])
+  {
+    ++suffix;
+  }
+
+  QVector< qint64> delta;
+  delta.reserve(2 + new_size - prefix - suffix);
+  delta.append(prefix);
+  delta.append(suffix);
+  delta.append(new_ids.mid(prefix, new_size - prefix - suffix));
+  return encode_varints(delta);
+}
+
+std::optional< QVector< qint64>> apply_tab_delta(const QVector< qint64>& old_ids, const QByteArray& delta) {
+  auto values = decode_varints(delta);
+  if (!values || values->size() < 2) {
+    return std::nullopt;
+  }
+
+  auto prefix = (*values)[0];
+  auto suffix = (*values)[1];
+  if (prefix < 0 || suffix < 0 || prefix + suffix > old_ids.size()) {
+    return std::nullopt;
+  }
+
+  QVector< qint64> ids;
+  ids.reserve(static_cast< int>(prefix + suffix) + values->size() - 2);
+  ids.append(old_ids.mid(0, static_cast< int>(prefix)));
+  ids.append(values->mid(2));
+  ids.append(old_ids.mid(old_ids.size() - static_cast< int>(suffix)));
+  return ids;
+}
+
+std::optional< QVector< qint64>> tab_version_ids(bool is_keyframe, const QByteArray& data) {
+  auto values = decode_varints(data);
+  if (!values || is_keyframe) {
+    return values;
+  }
+  if (values->size() < 2) {
+    return std::nullopt;
+  }
+  return values->mid(2);
+}
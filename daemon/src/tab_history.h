@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+#include <optional>
+
+/// Encoding of tab list versions stored in workspace_tab_version.
+///
+/// A keyframe holds the full url id list, see encode_varints().
+/// A delta holds the varints [prefix, suffix, middle ids...]: the new list
+/// keeps the first @c prefix and last @c suffix ids of the previous version
+/// and replaces everything in between with the middle ids. Opening or
+/// closing one tab therefore costs a few bytes regardless of list length.
+
+/// Delta turning @p old_ids into @p new_ids.
+QByteArray encode_tab_delta(const QVector< qint64>& old_ids, const QVector< qint64>& new_ids);
+
+/// Apply @p delta to the previous version @p old_ids.
+/// @return nullopt if the delta is malformed or does not fit @p old_ids.
+std::optional< QVector< qint64>> apply_tab_delta(const QVector< qint64>& old_ids, const QByteArray& delta);
+
+/// Url ids referenced by a stored version, for dictionary garbage collection.
+std::optional< QVector< qint64>> tab_version_ids(bool is_keyframe, const QByteArray& data);
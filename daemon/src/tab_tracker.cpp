@@ -1,6 +1,6 @@
 #include "tab_tracker.h"
 #include "journal_log.h"
-#include "workspace_db.h"
+#include "workspace_storage.h"
 
 #include <QDir>
 #include <QNetworkReply>
@@ -85,7 +85,7 @@ static QHash< int, QString> get_desktop_names() {
   return result;
 }
 
-Tab_tracker::Tab_tracker(Workspace_db& db, QObject* parent)
+Tab_tracker::Tab_tracker(Workspace_storage& db, QObject* parent)
   : QObject(parent)
   , _db(db)
 {
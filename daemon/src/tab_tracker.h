@@ -5,7 +5,7 @@
 #include <QObject>
 #include <QTimer>
 
-class Workspace_db;
+class Workspace_storage;
 
 /// Connects to the BroTab event socket and auto-saves tabs for all active
 /// workspaces whenever tab changes are detected (debounced).
@@ -13,7 +13,7 @@ class Tab_tracker : public QObject {
   Q_OBJECT
 
  public:
-  explicit Tab_tracker(Workspace_db& db, QObject* parent = nullptr);
+  explicit Tab_tracker(Workspace_storage& db, QObject* parent = nullptr);
 
   /// Try to connect to the BroTab event socket. Retries periodically if unavailable.
   void start();
@@ -30,7 +30,7 @@ class Tab_tracker : public QObject {
  private:
   void save_tabs_from_response(const QByteArray& body);
 
-  Workspace_db& _db;
+  Workspace_storage& _db;
 
   QLocalSocket _socket;
   QTimer _debounce_timer;
@@ -0,0 +1,43 @@
+#include "varint_codec.h"
+
+QByteArray encode_varints(const QVector< qint64>& values) {
+  QByteArray data;
+  data.reserve(values.size() * 2);
+
+  for (auto value : values) {
+    auto bits = static_cast< quint64>(value);
+    while (bits >= 0x80) {
+      data.append(static_cast< char>((bits & 0x7f) | 0x80));
+      bits >>= 7;
+    }
+    data.append(static_cast< char>(bits));
+  }
+  return data;
+}
+
+std::optional< QVector< qint64>> decode_varints(const QByteArray& data) {
+  QVector< qint64> values;
+
+  quint64 value = 0;
+  int shift = 0;
+  for (auto c : data) {
+    auto byte = static_cast< quint8>(c);
+    if (shift > 56) {
+      return std::nullopt;
+    }
+    value |= static_cast< quint64>(byte & 0x7f) << shift;
+
+    if (byte & 0x80) {
+      shift += 7;
+      continue;
+    }
+    values.append(static_cast< qint64>(value));
+    value = 0;
+    shift = 0;
+  }
+
+  if (shift != 0) {
+    return std::nullopt;
+  }
+  return values;
+}
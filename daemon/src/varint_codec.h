@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+#include <optional>
+
+/// Encode non-negative integers as LEB128 varints (7 bits per byte,
+/// high bit set on every byte but the last). Small ids take one byte.
+QByteArray encode_varints(const QVector< qint64>& values);
+
+/// Inverse of encode_varints.
+/// @return nullopt if @p data is truncated or a value overflows 63 bits.
+std::optional< QVector< qint64>> decode_varints(const QByteArray& data);
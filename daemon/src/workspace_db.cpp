@@ -1,7 +1,10 @@
 #include "workspace_db.h"
 #include "enum_strings.h"
 #include "journal_log.h"
+#include "tab_history.h"
+#include "varint_codec.h"
 
+#include <QCryptographicHash>
 #include <QDateTime>
 #include <QDir>
 #include <QFile>
@@ -10,6 +13,10 @@
 #include <QSqlQuery>
 #include <QTextStream>
 
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+
 static Claude_state parse_state(const QString& s) {
   auto state = from_wire_string< Claude_state>(s);
   if (!state) {
@@ -20,7 +27,53 @@ static Claude_state parse_state(const QString& s) {
   return *state;
 }
 
-Workspace_db::Workspace_db(const QString& db_path) {
+/// Bind the seven claude_session columns of @p status starting at @p first:
+/// workspace_name, session_id, state, tool_name, wait_reason, wait_message, state_since_ms.
+static void bind_claude_status(QSqlQuery& query, int first, const Claude_workspace_status& status) {
+  auto nullable = [](const QString& value) {
+    return value.isEmpty() ? QVariant() : QVariant(value);
+  };
+  query.bindValue(first + 0, status.workspace_name);
+  query.bindValue(first + 1, nullable(status.session_id));
+  query.bindValue(first + 2, to_wire_string(status.state));
+  query.bindValue(first + 3, nullable(status.tool_name));
+  query.bindValue(first + 4, nullable(status.wait_reason));
+  query.bindValue(first + 5, nullable(status.wait_message));
+  query.bindValue(first + 6, status.state_since_ms);
+}
+
+/// Inverse of bind_claude_status for a result row laid out the same way.
+static Claude_workspace_status read_claude_status(const QSqlQuery& query, int first) {
+  Claude_workspace_status status;
+  status.workspace_name = query.value(first + 0).toString();
+  status.session_id     = query.value(first + 1).toString();
+  status.state          = parse_state(query.value(first + 2).toString());
+  status.tool_name      = query.value(first + 3).toString();
+  status.wait_reason    = query.value(first + 4).toString();
+  status.wait_message   = query.value(first + 5).toString();
+  status.state_since_ms = query.value(first + 6).toLongLong();
+  return status;
+}
+
+Workspace_db::Workspace_db(const QString& db_path)
+  : _writer(db_path, _writer_connection_name, _writer_queue_capacity)
+  , _reader_statements(_reader_count)
+  , _readers(db_path, _reader_connection_prefix, _reader_count)
+{
+  _claude_commit_timer.setSingleShot(true);
+  _claude_commit_timer.setInterval(_default_claude_commit_window);
+  QObject::connect(&_claude_commit_timer, &QTimer::timeout, [this]() {
+    commit_claude_writes();
+  });
+  _claude_checkpoint_timer.setInterval(_claude_checkpoint_interval);
+  QObject::connect(&_claude_checkpoint_timer, &QTimer::timeout, [this]() {
+    checkpoint_claude_sessions();
+  });
+  _maintenance_timer.setInterval(_maintenance_check_interval);
+  QObject::connect(&_maintenance_timer, &QTimer::timeout, [this]() {
+    run_maintenance();
+  });
+
   auto dir_path = QFileInfo(db_path).absolutePath();
   if (!QDir().mkpath(dir_path)) {
     qCCritical(logServer, "failed to create database directory '%s'", qPrintable(dir_path));
@@ -44,11 +97,54 @@ Workspace_db::Workspace_db(const QString& db_path) {
     qCWarning(logServer, "PRAGMA foreign_keys=ON failed: %s",
       qPrintable(pragma.lastError().text()));
   }
+  if (!pragma.exec("PRAGMA wal_autocheckpoint=0")) {
+    qCWarning(logServer, "PRAGMA wal_autocheckpoint=0 failed: %s",
+      qPrintable(pragma.lastError().text()));
+  }
 
-  create_tables();
+  migrate_schema();
+  check_auto_vacuum();
+  prepare_read_statements();
+  load_mirror();
+
+  _writer.start([this](QSqlDatabase& db) {
+    QSqlQuery writer_pragma(db);
+    if (!writer_pragma.exec("PRAGMA foreign_keys=ON")) {
+      qCWarning(logServer, "db writer: PRAGMA foreign_keys=ON failed: %s",
+        qPrintable(writer_pragma.lastError().text()));
+    }
+    // Checkpoints are scheduled by run_maintenance(), not by the commit
+    // that happens to cross the page threshold.
+    if (!writer_pragma.exec("PRAGMA wal_autocheckpoint=0")) {
+      qCWarning(logServer, "db writer: PRAGMA wal_autocheckpoint=0 failed: %s",
+        qPrintable(writer_pragma.lastError().text()));
+    }
+    prepare_write_statements(db);
+    load_url_dictionary(db);
+  });
+  _readers.start(
+    [this](QSqlDatabase& db, int worker) {
+      prepare_reader_statements(db, worker);
+    },
+    [this](QSqlDatabase&, int worker) {
+      _reader_statements[worker].clear();
+    }
+  );
+  _claude_checkpoint_timer.start();
+  _maintenance_timer.start();
 }
 
 Workspace_db::~Workspace_db() {
+  checkpoint_claude_sessions();
+
+  // Write statements belong to the writer connection and must be released
+  // on its thread; the barrier also commits everything still queued.
+  _writer.submit("shutdown", [this](QSqlDatabase&) {
+    _write_statements.clear();
+  });
+  _writer.flush();
+
+  _statements.clear();
   _db.close();
   _db = QSqlDatabase();
   QSqlDatabase::removeDatabase(_connection_name);
@@ -58,34 +154,219 @@ bool Workspace_db::is_open() const {
   return _db.isOpen();
 }
 
-void Workspace_db::create_tables() {
+void Workspace_db::flush() {
+  commit_claude_writes();
+  _writer.flush();
+}
+
+Db_writer_stats Workspace_db::writer_stats() const {
+  return _writer.stats();
+}
+
+QJsonObject Workspace_db::storage_stats() const {
+  auto stats = writer_stats();
+
+  QJsonObject obj;
+  obj["backend"] = "sqlite";
+  obj["queue_depth"] = static_cast< qint64>(stats.depth);
+  obj["queue_max_depth"] = static_cast< qint64>(stats.max_depth);
+  obj["queue_capacity"] = static_cast< qint64>(stats.capacity);
+  obj["executed"] = static_cast< qint64>(stats.executed);
+  obj["blocked_submits"] = static_cast< qint64>(stats.blocked_submits);
+  obj["last_latency_us"] = static_cast< qint64>(stats.last_latency_us);
+  obj["max_latency_us"] = static_cast< qint64>(stats.max_latency_us);
+  obj["avg_latency_us"] = stats.executed > 0
+    ? static_cast< qint64>(stats.total_latency_us / static_cast< std::int64_t>(stats.executed))
+    : 0;
+
+  auto maintenance = maintenance_stats();
+  obj["wal_bytes"] = maintenance.wal_bytes;
+  obj["checkpoints"] = maintenance.checkpoints;
+  obj["forced_checkpoints"] = maintenance.forced_checkpoints;
+  obj["last_checkpoint_us"] = maintenance.last_checkpoint_us;
+  obj["max_checkpoint_us"] = maintenance.max_checkpoint_us;
+  obj["last_checkpoint_wal_pages"] = maintenance.last_checkpoint_wal_pages;
+  obj["last_checkpoint_busy"] = maintenance.last_checkpoint_busy;
+  obj["vacuumed_pages"] = maintenance.vacuumed_pages;
+  return obj;
+}
+
+Db_maintenance_stats Workspace_db::maintenance_stats() const {
+  Db_maintenance_stats stats;
+  {
+    std::lock_guard lock(_maintenance_mutex);
+    stats = _maintenance_stats;
+  }
+  stats.wal_bytes = wal_bytes();
+  return stats;
+}
+
+// --- Maintenance ---
+
+qint64 Workspace_db::wal_bytes() const {
+  QFileInfo wal(_db.databaseName() + "-wal");
+  return wal.exists() ? wal.size() : 0;
+}
+
+void Workspace_db::check_auto_vacuum() {
   QSqlQuery query(_db);
+  if (query.exec("PRAGMA auto_vacuum") && query.next() && query.value(0).toInt() == 2) {
+    return;
+  }
+  // The VACUUM rewrites the whole file, so it waits for the writer to idle.
+  qCInfo(logServer, "database will switch to incremental auto_vacuum when idle");
+  _auto_vacuum_pending = true;
+}
 
-  if (!query.exec(
+void Workspace_db::enable_incremental_vacuum(QSqlDatabase& db) {
+  // auto_vacuum only takes effect on an empty file or after a full VACUUM.
+  QSqlQuery query(db);
+  auto started = std::chrono::steady_clock::now();
+  if (!query.exec("PRAGMA auto_vacuum=INCREMENTAL") || !query.exec("VACUUM")) {
+    qCWarning(logServer, "maintenance: failed to enable incremental auto_vacuum: %s",
+      qPrintable(query.lastError().text()));
+    return;
+  }
+  qCInfo(logServer, "maintenance: switched to incremental auto_vacuum in %lld ms",
+    static_cast< long long>(std::chrono::duration_cast< std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - started).count()));
+}
+
+void Workspace_db::run_maintenance() {
+  auto idle = _writer.idle_for() >= _maintenance_idle_after;
+  // Pending even if nothing was written since start.
+  auto convert = idle && _auto_vacuum_pending;
+  if (!convert && _writer.submitted() == _maintained_at) {
+    return;
+  }
+
+  auto wal = wal_bytes();
+  auto forced = !idle && wal >= _wal_force_checkpoint_bytes;
+  if (!idle && !forced) {
+    return;
+  }
+
+  // Truncation waits for readers to finish, so it is left to idle runs.
+  // The VACUUM goes through the WAL, which is truncated right after it.
+  auto truncate = idle && (convert || wal >= _wal_truncate_bytes);
+  if (convert) {
+    // Tried once per start; a failure is logged and retried on the next one.
+    _auto_vacuum_pending = false;
+  }
+
+  _writer.submit("maintenance", [this, idle, forced, truncate, convert](QSqlDatabase& db) {
+    if (convert) {
+      enable_incremental_vacuum(db);
+    }
+
+    QSqlQuery query(db);
+
+    auto started = std::chrono::steady_clock::now();
+    auto checkpointed = query.exec(truncate
+      ? "PRAGMA wal_checkpoint(TRUNCATE)"
+      : "PRAGMA wal_checkpoint(PASSIVE)");
+    auto elapsed_us = std::chrono::duration_cast< std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - started).count();
+
+    if (!checkpointed) {
+      qCWarning(logServer, "maintenance: wal_checkpoint failed: %s",
+        qPrintable(query.lastError().text()));
+      return;
+    }
+    // Row: busy, WAL frames, frames checkpointed.
+    auto busy = query.next() && query.value(0).toInt() != 0;
+    auto wal_pages = query.value(1).toLongLong();
+
+    qint64 vacuumed = 0;
+    if (idle && query.exec("PRAGMA freelist_count") && query.next()) {
+      vacuumed = std::min< qint64>(query.value(0).toLongLong(), _vacuum_pages_per_run);
+      if (vacuumed > 0) {
+        // incremental_vacuum frees pages while it is stepped: drain it.
+        if (query.exec(QString("PRAGMA incremental_vacuum(%1)").arg(vacuumed))) {
+          while (query.next()) {
+          }
+        }
+        else {
+          qCWarning(logServer, "maintenance: incremental_vacuum failed: %s",
+            qPrintable(query.lastError().text()));
+          vacuumed = 0;
+        }
+      }
+    }
+
+    {
+      std::lock_guard lock(_maintenance_mutex);
+      auto& stats = _maintenance_stats;
+      ++stats.checkpoints;
+      stats.forced_checkpoints += forced ? 1 : 0;
+      stats.last_checkpoint_us = elapsed_us;
+      stats.max_checkpoint_us = std::max< qint64>(stats.max_checkpoint_us, elapsed_us);
+      stats.last_checkpoint_wal_pages = wal_pages;
+      stats.last_checkpoint_busy = busy;
+      stats.vacuumed_pages += vacuumed;
+    }
+
+    qCInfo(logServer, "maintenance: %s checkpoint of %lld pages in %lld us%s, vacuumed %lld pages",
+      truncate ? "truncating" : "passive", static_cast< long long>(wal_pages),
+      static_cast< long long>(elapsed_us), busy ? " (busy)" : "",
+      static_cast< long long>(vacuumed));
+  });
+
+  // Forced runs leave the idle run (truncate, vacuum) pending.
+  if (idle) {
+    _maintained_at = _writer.submitted();
+  }
+}
+
+// --- Schema ---
+
+/// One step of the schema history. Steps run in order inside a transaction,
+/// each bumping PRAGMA user_version to its version on success.
+struct Schema_migration {
+  int version;
+  const char* description;
+  bool (*apply)(QSqlQuery& query);
+};
+
+static bool exec_all(QSqlQuery& query, std::initializer_list< const char*> statements) {
+  for (const auto* sql : statements) {
+    if (!query.exec(QString::fromLatin1(sql))) {
+      qCCritical(logServer, "schema statement failed: %s\n  %s",
+        qPrintable(query.lastError().text()), sql);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool has_column(QSqlQuery& query, const QString& table, const QString& column) {
+  if (!query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+    return false;
+  }
+  while (query.next()) {
+    if (query.value(1).toString() == column) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool migrate_base_schema(QSqlQuery& query) {
+  if (!exec_all(query, {
     "CREATE TABLE IF NOT EXISTS workspace ("
     "  name TEXT PRIMARY KEY,"
     "  project_dir TEXT,"
     "  is_active INTEGER NOT NULL DEFAULT 0,"
     "  desktop_index INTEGER"
-    ")"
-  )) {
-    qCCritical(logServer, "failed to create workspace table: %s",
-      qPrintable(query.lastError().text()));
-  }
+    ")",
 
-  if (!query.exec(
     "CREATE TABLE IF NOT EXISTS workspace_tab ("
     "  workspace_name TEXT NOT NULL REFERENCES workspace(name) ON DELETE CASCADE,"
     "  position INTEGER NOT NULL,"
     "  url TEXT NOT NULL,"
     "  PRIMARY KEY (workspace_name, position)"
-    ")"
-  )) {
-    qCCritical(logServer, "failed to create workspace_tab table: %s",
-      qPrintable(query.lastError().text()));
-  }
+    ")",
 
-  if (!query.exec(
     "CREATE TABLE IF NOT EXISTS claude_session ("
     "  workspace_name TEXT PRIMARY KEY REFERENCES workspace(name),"
     "  session_id TEXT,"
@@ -94,303 +375,1043 @@ void Workspace_db::create_tables() {
     "  wait_reason TEXT,"
     "  wait_message TEXT,"
     "  state_since_ms INTEGER NOT NULL DEFAULT 0"
-    ")"
-  )) {
-    qCCritical(logServer, "failed to create claude_session table: %s",
-      qPrintable(query.lastError().text()));
-  }
+    ")",
+
+    // Append-only journal of Claude state changes; claude_session holds the
+    // state as of the sequence number stored in meta.claude_checkpoint_seq.
+    "CREATE TABLE IF NOT EXISTS claude_event ("
+    "  seq INTEGER PRIMARY KEY,"
+    "  workspace_name TEXT NOT NULL,"
+    "  session_id TEXT,"
+    "  state TEXT NOT NULL,"
+    "  tool_name TEXT,"
+    "  wait_reason TEXT,"
+    "  wait_message TEXT,"
+    "  ts_ms INTEGER NOT NULL"
+    ")",
 
-  if (!query.exec(
     "CREATE TABLE IF NOT EXISTS meta ("
     "  key TEXT PRIMARY KEY,"
     "  value TEXT"
     ")"
+  })) {
+    return false;
+  }
+
+  // Databases created before versioning may already have the column.
+  if (!has_column(query, "workspace", "sort_order")) {
+    return exec_all(query, {"ALTER TABLE workspace ADD COLUMN sort_order INTEGER"});
+  }
+  return true;
+}
+
+static bool migrate_listing_indexes(QSqlQuery& query) {
+  return exec_all(query, {
+    // Active desktops in display order; covers the listing columns.
+    "CREATE INDEX IF NOT EXISTS workspace_active_order"
+    " ON workspace (is_active, COALESCE(sort_order, desktop_index), name, project_dir)",
+    // Saved workspaces by name.
+    "CREATE INDEX IF NOT EXISTS workspace_saved_order"
+    " ON workspace (is_active, name, project_dir)"
+  });
+}
+
+static bool migrate_tab_count(QSqlQuery& query) {
+  return exec_all(query, {
+    "ALTER TABLE workspace ADD COLUMN tab_count INTEGER NOT NULL DEFAULT 0",
+    "UPDATE workspace SET tab_count ="
+    " (SELECT COUNT(*) FROM workspace_tab t WHERE t.workspace_name = workspace.name)"
+  });
+}
+
+static bool migrate_url_dictionary(QSqlQuery& query) {
+  if (!exec_all(query, {
+    "CREATE TABLE url_dictionary ("
+    "  id INTEGER PRIMARY KEY,"
+    "  url TEXT NOT NULL UNIQUE"
+    ")",
+
+    // One row per workspace: url_dictionary ids in tab order, varint-encoded.
+    "CREATE TABLE workspace_tab_list ("
+    "  workspace_name TEXT PRIMARY KEY REFERENCES workspace(name) ON DELETE CASCADE,"
+    "  url_ids BLOB NOT NULL"
+    ")",
+
+    "INSERT INTO url_dictionary (url) SELECT DISTINCT url FROM workspace_tab"
+  })) {
+    return false;
+  }
+
+  if (!query.exec(
+    "SELECT t.workspace_name, d.id FROM workspace_tab t"
+    " JOIN url_dictionary d ON d.url = t.url"
+    " ORDER BY t.workspace_name, t.position"
   )) {
-    qCCritical(logServer, "failed to create meta table: %s",
+    qCCritical(logServer, "failed to read workspace_tab for migration: %s",
       qPrintable(query.lastError().text()));
+    return false;
+  }
+  QHash< QString, QVector< qint64>> lists;
+  while (query.next()) {
+    lists[query.value(0).toString()].append(query.value(1).toLongLong());
+  }
+
+  query.prepare("INSERT INTO workspace_tab_list (workspace_name, url_ids) VALUES (?, ?)");
+  for (auto it = lists.cbegin(); it != lists.cend(); ++it) {
+    query.bindValue(0, it.key());
+    query.bindValue(1, encode_varints(*it));
+    if (!query.exec()) {
+      qCCritical(logServer, "failed to migrate tabs of '%s': %s",
+        qPrintable(it.key()), qPrintable(query.lastError().text()));
+      return false;
+    }
   }
 
-  // Migration: add sort_order column
-  query.exec("ALTER TABLE workspace ADD COLUMN sort_order INTEGER");
-  // Ignore error — column may already exist
+  return exec_all(query, {"DROP TABLE workspace_tab"});
 }
 
-void Workspace_db::ensure_workspace_exists(const QString& name) {
+static bool migrate_tab_history(QSqlQuery& query) {
+  return exec_all(query, {
+    // Version history of workspace_tab_list: keyframes store the full id
+    // list, other versions a delta against the previous one (tab_history.h).
+    "CREATE TABLE workspace_tab_version ("
+    "  workspace_name TEXT NOT NULL REFERENCES workspace(name) ON DELETE CASCADE,"
+    "  version INTEGER NOT NULL,"
+    "  ts_ms INTEGER NOT NULL,"
+    "  is_keyframe INTEGER NOT NULL,"
+    "  data BLOB NOT NULL,"
+    "  PRIMARY KEY (workspace_name, version)"
+    ")",
+
+    // The current lists become the first keyframe of every workspace.
+    "INSERT INTO workspace_tab_version (workspace_name, version, ts_ms, is_keyframe, data)"
+    " SELECT workspace_name, 1, CAST(strftime('%s', 'now') AS INTEGER) * 1000, 1, url_ids"
+    " FROM workspace_tab_list"
+  });
+}
+
+static const Schema_migration schema_migrations[] = {
+  {1, "base schema", migrate_base_schema},
+  {2, "workspace listing indexes", migrate_listing_indexes},
+  {3, "workspace.tab_count", migrate_tab_count},
+  {4, "interned tab lists", migrate_url_dictionary},
+  {5, "tab history", migrate_tab_history},
+};
+
+void Workspace_db::migrate_schema() {
   QSqlQuery query(_db);
-  query.prepare("INSERT OR IGNORE INTO workspace (name) VALUES (?)");
-  query.addBindValue(name);
-  if (!query.exec()) {
-    qCWarning(logServer, "ensure_workspace_exists failed for '%s': %s",
-      qPrintable(name), qPrintable(query.lastError().text()));
+
+  int version = 0;
+  if (query.exec("PRAGMA user_version") && query.next()) {
+    version = query.value(0).toInt();
+  }
+
+  const auto latest = schema_migrations[std::size(schema_migrations) - 1].version;
+  if (version > latest) {
+    qCWarning(logServer, "database schema version %d is newer than supported %d",
+      version, latest);
+    return;
+  }
+
+  for (const auto& migration : schema_migrations) {
+    if (migration.version <= version) {
+      continue;
+    }
+
+    _db.transaction();
+    if (!migration.apply(query)
+      || !query.exec(QString("PRAGMA user_version = %1").arg(migration.version)))
+    {
+      qCCritical(logServer, "schema migration %d (%s) failed, staying at version %d",
+        migration.version, migration.description, version);
+      _db.rollback();
+      return;
+    }
+    _db.commit();
+
+    qCInfo(logServer, "schema migrated to version %d (%s)",
+      migration.version, migration.description);
+    version = migration.version;
   }
 }
 
-// --- Workspaces ---
+/// Versions needed to rebuild a workspace's tab list as of a timestamp:
+/// the newest version at or before it, back to the keyframe it builds on.
+/// Binds: workspace_name, ts_ms, workspace_name, workspace_name.
+static const char* const tab_versions_at_sql =
+  "WITH target AS ("
+  "  SELECT MAX(version) AS v FROM workspace_tab_version"
+  "  WHERE workspace_name = ? AND ts_ms <= ?"
+  "), base AS ("
+  "  SELECT MAX(version) AS v FROM workspace_tab_version, target"
+  "  WHERE workspace_name = ? AND is_keyframe = 1 AND version <= target.v"
+  ")"
+  " SELECT is_keyframe, data FROM workspace_tab_version, target, base"
+  " WHERE workspace_name = ? AND version BETWEEN base.v AND target.v"
+  " ORDER BY version";
+
+void Workspace_db::prepare_read_statements() {
+  auto prepare = [this](Statement id, const char* sql) {
+    _statements.prepare(_db, id, QString::fromLatin1(sql));
+  };
+
+  prepare(Statement::GET_TAB_IDS,
+    "SELECT url_ids FROM workspace_tab_list WHERE workspace_name = ?"
+  );
+  prepare(Statement::GET_URL,
+    "SELECT url FROM url_dictionary WHERE id = ?"
+  );
+  prepare(Statement::GET_TAB_VERSIONS_AT, tab_versions_at_sql);
+}
 
-void Workspace_db::create_workspace(const QString& name, const QString& project_dir) {
-  QSqlQuery query(_db);
-  query.prepare(
+void Workspace_db::prepare_reader_statements(const QSqlDatabase& db, int worker) {
+  auto& statements = _reader_statements[worker];
+  statements.prepare(db, Statement::GET_TAB_IDS, QString::fromLatin1(
+    "SELECT url_ids FROM workspace_tab_list WHERE workspace_name = ?"
+  ));
+  statements.prepare(db, Statement::GET_URL, QString::fromLatin1(
+    "SELECT url FROM url_dictionary WHERE id = ?"
+  ));
+  statements.prepare(db, Statement::GET_TAB_VERSIONS_AT,
+    QString::fromLatin1(tab_versions_at_sql));
+}
+
+void Workspace_db::prepare_write_statements(const QSqlDatabase& db) {
+  auto prepare = [this, &db](Statement id, const char* sql) {
+    _write_statements.prepare(db, id, QString::fromLatin1(sql));
+  };
+
+  prepare(Statement::ENSURE_WORKSPACE,
+    "INSERT OR IGNORE INTO workspace (name) VALUES (?)"
+  );
+  prepare(Statement::CREATE_WORKSPACE,
     "INSERT INTO workspace (name, project_dir)"
     " VALUES (?, ?)"
     " ON CONFLICT(name) DO UPDATE"
     " SET project_dir = excluded.project_dir"
   );
-  query.addBindValue(name);
-  query.addBindValue(project_dir);
+  prepare(Statement::DEACTIVATE_DESKTOP,
+    "UPDATE workspace SET is_active = 0, desktop_index = NULL WHERE name = ?"
+  );
+  // sort_order is initialized from desktop_index the first time a workspace becomes active
+  prepare(Statement::UPSERT_ACTIVE_DESKTOP,
+    "INSERT INTO workspace (name, is_active, desktop_index, sort_order)"
+    " VALUES (?, 1, ?, ?)"
+    " ON CONFLICT(name) DO UPDATE"
+    " SET is_active = 1,"
+    "     desktop_index = excluded.desktop_index,"
+    "     sort_order = COALESCE(sort_order, excluded.desktop_index)"
+  );
+  prepare(Statement::SET_SORT_ORDER,
+    "UPDATE workspace SET sort_order = ? WHERE name = ?"
+  );
+  prepare(Statement::GET_TAB_IDS,
+    "SELECT url_ids FROM workspace_tab_list WHERE workspace_name = ?"
+  );
+  prepare(Statement::GET_TAB_HEAD,
+    "SELECT MAX(version), MAX(CASE WHEN is_keyframe THEN version END)"
+    " FROM workspace_tab_version WHERE workspace_name = ?"
+  );
+  prepare(Statement::INSERT_TAB_VERSION,
+    "INSERT INTO workspace_tab_version (workspace_name, version, ts_ms, is_keyframe, data)"
+    " VALUES (?, ?, ?, ?, ?)"
+  );
+  // Everything before the newest keyframe that is past retention (by age or
+  // by count) goes; that keyframe stays, so every kept version is restorable.
+  prepare(Statement::PRUNE_TAB_VERSIONS,
+    "DELETE FROM workspace_tab_version"
+    " WHERE workspace_name = ? AND version < ("
+    "   SELECT MAX(version) FROM workspace_tab_version"
+    "   WHERE workspace_name = ? AND is_keyframe = 1 AND (ts_ms < ? OR version <= ?)"
+    " )"
+  );
+  prepare(Statement::INSERT_URL,
+    "INSERT INTO url_dictionary (url) VALUES (?)"
+  );
+  prepare(Statement::UPSERT_TAB_LIST,
+    "INSERT INTO workspace_tab_list (workspace_name, url_ids)"
+    " VALUES (?, ?)"
+    " ON CONFLICT(workspace_name) DO UPDATE"
+    " SET url_ids = excluded.url_ids"
+  );
+  prepare(Statement::SET_TAB_COUNT,
+    "UPDATE workspace SET tab_count = ? WHERE name = ?"
+  );
+  prepare(Statement::UPSERT_CLAUDE_SESSION,
+    "INSERT INTO claude_session (workspace_name, session_id, state, tool_name,"
+    "   wait_reason, wait_message, state_since_ms)"
+    " VALUES (?, ?, ?, ?, ?, ?, ?)"
+    " ON CONFLICT(workspace_name) DO UPDATE SET"
+    "   session_id = excluded.session_id,"
+    "   state = excluded.state,"
+    "   tool_name = excluded.tool_name,"
+    "   wait_reason = excluded.wait_reason,"
+    "   wait_message = excluded.wait_message,"
+    "   state_since_ms = excluded.state_since_ms"
+  );
+  prepare(Statement::APPEND_CLAUDE_EVENT,
+    "INSERT INTO claude_event (seq, workspace_name, session_id, state, tool_name,"
+    "   wait_reason, wait_message, ts_ms)"
+    " VALUES (?, ?, ?, ?, ?, ?, ?, ?)"
+  );
+  // Only checkpointed entries are dropped: older than the retention cutoff,
+  // or beyond the row cap counted back from the checkpoint.
+  prepare(Statement::COMPACT_CLAUDE_EVENTS,
+    "DELETE FROM claude_event"
+    " WHERE seq <= ? AND (ts_ms < ? OR seq <= ?)"
+  );
+  prepare(Statement::SET_META,
+    "INSERT OR REPLACE INTO meta (key, value) VALUES (?, ?)"
+  );
+}
 
-  if (!query.exec()) {
-    qCWarning(logServer, "create_workspace: failed for '%s': %s",
-      qPrintable(name), qPrintable(query.lastError().text()));
+static std::optional< int> optional_int(const QVariant& value) {
+  if (value.isNull()) {
+    return std::nullopt;
   }
+  return value.toInt();
 }
 
-QString Workspace_db::get_project_dir(const QString& workspace_name) const {
+static QVariant to_variant(const std::optional< int>& value) {
+  return value ? QVariant(*value) : QVariant();
+}
+
+void Workspace_db::load_mirror() {
   QSqlQuery query(_db);
-  query.prepare("SELECT project_dir FROM workspace WHERE name = ?");
-  query.addBindValue(workspace_name);
+  query.setForwardOnly(true);
 
-  if (query.exec() && query.next()) {
-    return query.value(0).toString();
+  if (!query.exec(
+    "SELECT name, project_dir, is_active, desktop_index, sort_order, tab_count"
+    " FROM workspace"
+  )) {
+    qCCritical(logServer, "failed to load workspaces: %s",
+      qPrintable(query.lastError().text()));
   }
-  return {};
+  while (query.next()) {
+    Workspace_row row;
+    row.project_dir   = query.value(1).toString();
+    row.is_active     = query.value(2).toBool();
+    row.desktop_index = optional_int(query.value(3));
+    row.sort_order    = optional_int(query.value(4));
+    row.tab_count     = query.value(5).toInt();
+    auto name = query.value(0).toString();
+    _path_index.insert(row.project_dir, name);
+    _workspaces.insert(name, row);
+  }
+
+  if (!query.exec(
+    "SELECT workspace_name, session_id, state, tool_name,"
+    " wait_reason, wait_message, state_since_ms"
+    " FROM claude_session"
+  )) {
+    qCCritical(logServer, "failed to load claude sessions: %s",
+      qPrintable(query.lastError().text()));
+  }
+  while (query.next()) {
+    auto status = read_claude_status(query, 0);
+    _claude_sessions.insert(status.workspace_name, status);
+  }
+
+  if (!query.exec("SELECT key, value FROM meta")) {
+    qCCritical(logServer, "failed to load meta: %s",
+      qPrintable(query.lastError().text()));
+  }
+  while (query.next()) {
+    _meta.insert(query.value(0).toString(), query.value(1).toString());
+  }
+
+  replay_claude_events();
+  load_tab_digests();
+  rebuild_order();
+
+  qCInfo(logServer, "loaded %d workspaces and %d claude sessions",
+    static_cast< int>(_workspaces.size()), static_cast< int>(_claude_sessions.size()));
 }
 
-QString Workspace_db::find_workspace_by_path(const QString& path) const {
+void Workspace_db::replay_claude_events() {
   QSqlQuery query(_db);
-  // Find all workspaces where project_dir is a prefix of the given path.
-  // The longest match wins (most specific workspace).
-  // Uses SUBSTR instead of LIKE to avoid wildcards in project_dir (e.g. _ in paths).
+  query.setForwardOnly(true);
+
+  qint64 checkpoint = 0;
+  query.prepare("SELECT value FROM meta WHERE key = ?");
+  query.bindValue(0, QString::fromLatin1(_claude_checkpoint_key));
+  if (query.exec() && query.next()) {
+    checkpoint = query.value(0).toLongLong();
+  }
+
+  if (query.exec("SELECT MAX(seq) FROM claude_event") && query.next()) {
+    _next_claude_seq = std::max(checkpoint, query.value(0).toLongLong()) + 1;
+  }
+  else {
+    _next_claude_seq = checkpoint + 1;
+  }
+
   query.prepare(
-    "SELECT name FROM workspace"
-    " WHERE project_dir IS NOT NULL"
-    "   AND project_dir != ''"
-    "   AND (? = project_dir"
-    "     OR SUBSTR(?, 1, LENGTH(project_dir) + 1) = project_dir || '/')"
-    " ORDER BY LENGTH(project_dir) DESC"
-    " LIMIT 1"
+    "SELECT workspace_name, session_id, state, tool_name,"
+    " wait_reason, wait_message, ts_ms"
+    " FROM claude_event WHERE seq > ? ORDER BY seq"
   );
-  query.addBindValue(path);
-  query.addBindValue(path);
+  query.bindValue(0, checkpoint);
+  if (!query.exec()) {
+    qCCritical(logServer, "failed to replay claude events: %s",
+      qPrintable(query.lastError().text()));
+    return;
+  }
 
-  if (query.exec() && query.next()) {
-    return query.value(0).toString();
+  int replayed = 0;
+  while (query.next()) {
+    auto status = read_claude_status(query, 0);
+    if (!_workspaces.contains(status.workspace_name)) {
+      _workspaces.insert(status.workspace_name, {});
+    }
+    _unchecked_claude_sessions.insert(status.workspace_name);
+    _claude_sessions.insert(status.workspace_name, status);
+    ++replayed;
+  }
+
+  if (replayed > 0) {
+    qCInfo(logClaude, "replayed %d claude events after checkpoint %lld",
+      replayed, static_cast< long long>(checkpoint));
   }
-  return {};
 }
 
-QJsonArray Workspace_db::all_workspaces() const {
-  QJsonArray result;
+void Workspace_db::load_tab_digests() {
   QSqlQuery query(_db);
+  query.setForwardOnly(true);
 
-  if (query.exec(
-    "SELECT w.name, w.project_dir, w.is_active,"
-    "  (SELECT COUNT(*) FROM workspace_tab t WHERE t.workspace_name = w.name) AS tab_count"
-    " FROM workspace w"
-    " ORDER BY w.is_active DESC, COALESCE(w.sort_order, w.desktop_index), w.name"
-  )) {
+  if (!query.exec("SELECT workspace_name, url_ids FROM workspace_tab_list")) {
+    qCWarning(logServer, "failed to load tab lists: %s",
+      qPrintable(query.lastError().text()));
+    return;
+  }
+  QHash< QString, QVector< qint64>> lists;
+  QHash< qint64, QString> urls;
+  while (query.next()) {
+    auto ids = decode_varints(query.value(1).toByteArray());
+    if (!ids) {
+      // Left without a digest: the next save rewrites it.
+      continue;
+    }
+    for (auto id : *ids) {
+      urls.insert(id, {});
+    }
+    lists.insert(query.value(0).toString(), std::move(*ids));
+  }
+
+  if (!query.exec("SELECT id, url FROM url_dictionary")) {
+    qCWarning(logServer, "failed to load url dictionary: %s",
+      qPrintable(query.lastError().text()));
+    return;
+  }
+  while (query.next()) {
+    auto it = urls.find(query.value(0).toLongLong());
+    if (it != urls.end()) {
+      *it = query.value(1).toString();
+    }
+  }
+
+  for (auto it = lists.cbegin(); it != lists.cend(); ++it) {
+    QStringList list;
+    list.reserve(it->size());
+    for (auto id : *it) {
+      list.append(urls.value(id));
+    }
+    _tab_digests.insert(it.key(), tab_digest(list));
+  }
+}
+
+void Workspace_db::load_url_dictionary(QSqlDatabase& db) {
+  QSqlQuery query(db);
+  query.setForwardOnly(true);
+
+  // Ids still referenced by a tab list or a history version; the rest is
+  // garbage from earlier saves and is dropped before the cache is built.
+  QSet< qint64> referenced;
+  if (!query.exec("SELECT url_ids FROM workspace_tab_list")) {
+    qCWarning(logServer, "db writer: failed to scan tab lists: %s",
+      qPrintable(query.lastError().text()));
+    return;
+  }
+  bool collect = true;
+  while (query.next()) {
+    auto ids = decode_varints(query.value(0).toByteArray());
+    if (!ids) {
+      // Cannot tell what a corrupt list references: keep every url.
+      qCWarning(logServer, "db writer: corrupt tab list, skipping url collection");
+      collect = false;
+      break;
+    }
+    for (auto id : *ids) {
+      referenced.insert(id);
+    }
+  }
+
+  if (collect && query.exec("SELECT is_keyframe, data FROM workspace_tab_version")) {
     while (query.next()) {
-      QJsonObject obj;
-      obj["name"] = query.value(0).toString();
-      obj["project_dir"] = query.value(1).toString();
-      obj["is_active"] = query.value(2).toBool();
-      obj["tab_count"] = query.value(3).toInt();
-      result.append(obj);
+      auto ids = tab_version_ids(query.value(0).toBool(), query.value(1).toByteArray());
+      if (!ids) {
+        qCWarning(logServer, "db writer: corrupt tab history, skipping url collection");
+        collect = false;
+        break;
+      }
+      for (auto id : *ids) {
+        referenced.insert(id);
+      }
     }
   }
-  return result;
+  else if (collect) {
+    qCWarning(logServer, "db writer: failed to scan tab history: %s",
+      qPrintable(query.lastError().text()));
+    collect = false;
+  }
+
+  if (!query.exec("SELECT id, url FROM url_dictionary")) {
+    qCWarning(logServer, "db writer: failed to load url dictionary: %s",
+      qPrintable(query.lastError().text()));
+    return;
+  }
+  QVector< qint64> unused;
+  while (query.next()) {
+    auto id = query.value(0).toLongLong();
+    if (collect && !referenced.contains(id)) {
+      unused.append(id);
+      continue;
+    }
+    _url_ids.insert(query.value(1).toString(), id);
+  }
+
+  if (unused.isEmpty()) {
+    return;
+  }
+  db.transaction();
+  query.prepare("DELETE FROM url_dictionary WHERE id = ?");
+  for (auto id : unused) {
+    query.bindValue(0, id);
+    query.exec();
+  }
+  db.commit();
+  qCInfo(logServer, "db writer: dropped %d unused urls", static_cast< int>(unused.size()));
 }
 
-void Workspace_db::sync_active_desktops(const QVector< Desktop_info>& desktops) {
-  _db.transaction();
+void Workspace_db::rebuild_order() {
+  _active_order.clear();
+  _saved_order.clear();
+
+  for (auto it = _workspaces.cbegin(); it != _workspaces.cend(); ++it) {
+    (it->is_active ? _active_order : _saved_order).append(it.key());
+  }
+
+  // Same order as SQL "ORDER BY COALESCE(sort_order, desktop_index)": NULLs first.
+  auto order_key = [this](const QString& name) {
+    const auto& row = *_workspaces.constFind(name);
+    return row.sort_order ? row.sort_order : row.desktop_index;
+  };
+  std::sort(_active_order.begin(), _active_order.end(),
+    [&order_key](const QString& a, const QString& b) {
+      auto key_a = order_key(a);
+      auto key_b = order_key(b);
+      if (key_a != key_b) {
+        return key_a < key_b;
+      }
+      return a < b;
+    });
+
+  std::sort(_saved_order.begin(), _saved_order.end());
+}
 
-  QSqlQuery reset(_db);
-  if (!reset.exec("UPDATE workspace SET is_active = 0, desktop_index = NULL")) {
-    qCWarning(logServer, "sync_active_desktops: reset failed: %s",
-      qPrintable(reset.lastError().text()));
-    _db.rollback();
+void Workspace_db::ensure_workspace_exists(const QString& name) {
+  if (_workspaces.contains(name)) {
     return;
   }
 
+  _workspaces.insert(name, {});
+  rebuild_order();
+
+  _writer.submit("ensure_workspace_exists", [this, name](QSqlDatabase&) {
+    auto query = _write_statements.acquire(Statement::ENSURE_WORKSPACE);
+    query->bindValue(0, name);
+    if (!query->exec()) {
+      qCWarning(logServer, "ensure_workspace_exists failed for '%s': %s",
+        qPrintable(name), qPrintable(query->lastError().text()));
+    }
+  });
+}
+
+// --- Workspaces ---
+
+void Workspace_db::create_workspace(const QString& name, const QString& project_dir) {
+  auto existed = _workspaces.contains(name);
+  auto& row = _workspaces[name];
+  _path_index.remove(row.project_dir, name);
+  _path_index.insert(project_dir, name);
+  row.project_dir = project_dir;
+  if (!existed) {
+    rebuild_order();
+  }
+
+  _writer.submit("create_workspace", [this, name, project_dir](QSqlDatabase&) {
+    auto query = _write_statements.acquire(Statement::CREATE_WORKSPACE);
+    query->bindValue(0, name);
+    query->bindValue(1, project_dir);
+
+    if (!query->exec()) {
+      qCWarning(logServer, "create_workspace: failed for '%s': %s",
+        qPrintable(name), qPrintable(query->lastError().text()));
+    }
+  });
+}
+
+QString Workspace_db::get_project_dir(const QString& workspace_name) const {
+  auto it = _workspaces.constFind(workspace_name);
+  return it != _workspaces.cend() ? it->project_dir : QString();
+}
+
+QString Workspace_db::find_workspace_by_path(const QString& path) const {
+  return _path_index.find(path);
+}
+
+QJsonArray Workspace_db::all_workspaces() const {
+  QJsonArray result;
+
+  auto append = [this, &result](const QString& name) {
+    const auto& row = *_workspaces.constFind(name);
+    QJsonObject obj;
+    obj["name"] = name;
+    obj["project_dir"] = row.project_dir;
+    obj["is_active"] = row.is_active;
+    obj["tab_count"] = row.tab_count;
+    result.append(obj);
+  };
+
+  for (const auto& name : _active_order) {
+    append(name);
+  }
+  for (const auto& name : _saved_order) {
+    append(name);
+  }
+  return result;
+}
+
+void Workspace_db::sync_active_desktops(const QVector< Desktop_info>& desktops) {
+  // Diff the snapshot against the mirror (the last applied state) and write
+  // only rows whose active flag or desktop index actually changed.
+  QHash< QString, int> incoming;
   for (const auto& desktop : desktops) {
-    QSqlQuery query(_db);
-    query.prepare(
-      "INSERT INTO workspace (name, is_active, desktop_index)"
-      " VALUES (?, 1, ?)"
-      " ON CONFLICT(name) DO UPDATE"
-      " SET is_active = 1,"
-      "     desktop_index = excluded.desktop_index"
-    );
-    query.addBindValue(desktop.name);
-    query.addBindValue(desktop.index);
+    incoming.insert(desktop.name, desktop.index);
+  }
 
-    if (!query.exec()) {
-      qCWarning(logServer, "sync_active_desktops: failed for '%s': %s",
-        qPrintable(desktop.name), qPrintable(query.lastError().text()));
-      _db.rollback();
-      return;
+  QStringList deactivated;
+  for (auto it = _workspaces.begin(); it != _workspaces.end(); ++it) {
+    if (it->is_active && !incoming.contains(it.key())) {
+      it->is_active = false;
+      it->desktop_index.reset();
+      deactivated.append(it.key());
     }
   }
 
-  // Initialize sort_order from desktop_index where not yet set
-  QSqlQuery init(_db);
-  if (!init.exec("UPDATE workspace SET sort_order = desktop_index WHERE is_active = 1 AND sort_order IS NULL")) {
-    qCWarning(logServer, "sync_active_desktops: sort_order init failed: %s",
-      qPrintable(init.lastError().text()));
+  QVector< Desktop_info> activated;
+  for (auto it = incoming.cbegin(); it != incoming.cend(); ++it) {
+    auto& row = _workspaces[it.key()];
+    if (row.is_active && row.desktop_index == it.value()) {
+      continue;
+    }
+    row.is_active = true;
+    row.desktop_index = it.value();
+    if (!row.sort_order) {
+      row.sort_order = it.value();
+    }
+    activated.append({it.value(), it.key()});
   }
 
-  _db.commit();
+  if (deactivated.isEmpty() && activated.isEmpty()) {
+    return;
+  }
+  rebuild_order();
+
+  _writer.submit("sync_active_desktops", [this, deactivated, activated](QSqlDatabase& db) {
+    db.transaction();
+
+    {
+      auto deactivate = _write_statements.acquire(Statement::DEACTIVATE_DESKTOP);
+      for (const auto& name : deactivated) {
+        deactivate->bindValue(0, name);
+        if (!deactivate->exec()) {
+          qCWarning(logServer, "sync_active_desktops: deactivate failed for '%s': %s",
+            qPrintable(name), qPrintable(deactivate->lastError().text()));
+          db.rollback();
+          return;
+        }
+      }
+    }
+
+    {
+      auto upsert = _write_statements.acquire(Statement::UPSERT_ACTIVE_DESKTOP);
+      for (const auto& desktop : activated) {
+        upsert->bindValue(0, desktop.name);
+        upsert->bindValue(1, desktop.index);
+        upsert->bindValue(2, desktop.index);
+
+        if (!upsert->exec()) {
+          qCWarning(logServer, "sync_active_desktops: failed for '%s': %s",
+            qPrintable(desktop.name), qPrintable(upsert->lastError().text()));
+          db.rollback();
+          return;
+        }
+      }
+    }
+
+    db.commit();
+  });
 }
 
 QVector< Workspace_info> Workspace_db::active_desktops() const {
   QVector< Workspace_info> result;
-  QSqlQuery query(_db);
-
-  if (query.exec(
-    "SELECT name, project_dir FROM workspace"
-    " WHERE is_active = 1"
-    " ORDER BY COALESCE(sort_order, desktop_index)"
-  )) {
-    while (query.next()) {
-      result.append({
-        query.value(0).toString(),
-        query.value(1).toString()
-      });
-    }
+  result.reserve(_active_order.size());
+  for (const auto& name : _active_order) {
+    result.append({name, _workspaces.constFind(name)->project_dir});
   }
   return result;
 }
 
 void Workspace_db::swap_desktop_order(const QString& name_a, const QString& name_b) {
-  // Read both values first, then write — single UPDATE with subqueries
-  // can see partially-updated rows in SQLite.
-  QSqlQuery read_a(_db);
-  read_a.prepare("SELECT sort_order FROM workspace WHERE name = ?");
-  read_a.addBindValue(name_a);
-
-  QSqlQuery read_b(_db);
-  read_b.prepare("SELECT sort_order FROM workspace WHERE name = ?");
-  read_b.addBindValue(name_b);
-
-  if (!read_a.exec() || !read_a.next() || !read_b.exec() || !read_b.next()) {
-    qCWarning(logServer, "swap_desktop_order: failed to read for '%s' <-> '%s'",
+  auto it_a = _workspaces.find(name_a);
+  auto it_b = _workspaces.find(name_b);
+  if (it_a == _workspaces.end() || it_b == _workspaces.end()) {
+    qCWarning(logServer, "swap_desktop_order: unknown workspace in '%s' <-> '%s'",
       qPrintable(name_a), qPrintable(name_b));
     return;
   }
 
-  auto order_a = read_a.value(0);
-  auto order_b = read_b.value(0);
+  std::swap(it_a->sort_order, it_b->sort_order);
+  rebuild_order();
 
-  QSqlQuery write_a(_db);
-  write_a.prepare("UPDATE workspace SET sort_order = ? WHERE name = ?");
-  write_a.addBindValue(order_b);
-  write_a.addBindValue(name_a);
+  auto order_a = to_variant(it_a->sort_order);
+  auto order_b = to_variant(it_b->sort_order);
+  _writer.submit("swap_desktop_order", [this, name_a, name_b, order_a, order_b](QSqlDatabase&) {
+    auto write = _write_statements.acquire(Statement::SET_SORT_ORDER);
+    write->bindValue(0, order_a);
+    write->bindValue(1, name_a);
+    bool ok = write->exec();
 
-  QSqlQuery write_b(_db);
-  write_b.prepare("UPDATE workspace SET sort_order = ? WHERE name = ?");
-  write_b.addBindValue(order_a);
-  write_b.addBindValue(name_b);
+    write->bindValue(0, order_b);
+    write->bindValue(1, name_b);
+    ok = ok && write->exec();
 
-  if (!write_a.exec() || !write_b.exec()) {
-    qCWarning(logServer, "swap_desktop_order: failed to write for '%s' <-> '%s'",
-      qPrintable(name_a), qPrintable(name_b));
-  }
+    if (!ok) {
+      qCWarning(logServer, "swap_desktop_order: failed to write for '%s' <-> '%s'",
+        qPrintable(name_a), qPrintable(name_b));
+    }
+  });
 }
 
 QString Workspace_db::active_desktop_name_at(int position) const {
-  QSqlQuery query(_db);
-  query.prepare(
-    "SELECT name FROM workspace"
-    " WHERE is_active = 1"
-    " ORDER BY COALESCE(sort_order, desktop_index)"
-    " LIMIT 1 OFFSET ?"
-  );
-  query.addBindValue(position);
-
-  if (query.exec() && query.next()) {
-    return query.value(0).toString();
-  }
-  return {};
+  return _active_order.value(position);
 }
 
 QVector< Workspace_info> Workspace_db::saved_workspaces() const {
   QVector< Workspace_info> result;
-  QSqlQuery query(_db);
-
-  if (query.exec(
-    "SELECT name, project_dir FROM workspace"
-    " WHERE is_active = 0"
-    " ORDER BY name"
-  )) {
-    while (query.next()) {
-      result.append({
-        query.value(0).toString(),
-        query.value(1).toString()
-      });
-    }
+  result.reserve(_saved_order.size());
+  for (const auto& name : _saved_order) {
+    result.append({name, _workspaces.constFind(name)->project_dir});
   }
   return result;
 }
 
 // --- Tabs ---
 
+QByteArray Workspace_db::tab_digest(const QStringList& urls) {
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  for (const auto& url : urls) {
+    hash.addData(url.toUtf8());
+    hash.addData("\n", 1);
+  }
+  return hash.result();
+}
+
 void Workspace_db::set_tabs(const QString& workspace_name, const QStringList& urls) {
+  // Digests of the stored lists are loaded at open, see load_tab_digests().
+  auto digest = tab_digest(urls);
+  auto known = _tab_digests.constFind(workspace_name);
+  if (known != _tab_digests.cend() && *known == digest) {
+    return;
+  }
+
+  // Taken as stored until the writer reports otherwise.
   ensure_workspace_exists(workspace_name);
+  _workspaces[workspace_name].tab_count = static_cast< int>(urls.size());
+  _tab_digests.insert(workspace_name, digest);
+
+  _writer.submit("set_tabs", [this, workspace_name, urls, digest](QSqlDatabase& db) {
+    QStringList interned;
+    auto fail = [this, &db, &workspace_name, &digest, &interned](const char* step, const QSqlError& error) {
+      qCWarning(logServer, "set_tabs: %s failed for '%s': %s",
+        step, qPrintable(workspace_name), qPrintable(error.text()));
+      db.rollback();
+      // Ids handed out inside the rolled back transaction no longer exist,
+      // and the history head is reloaded from what is actually stored.
+      for (const auto& url : interned) {
+        _url_ids.remove(url);
+      }
+      _tab_heads.remove(workspace_name);
+      auto stored_count = static_cast< int>(tab_head(workspace_name).ids.size());
+
+      // Forget the digest, so the same list is written again on the next
+      // save, and restore the stored count. A later save of another list
+      // has already replaced both.
+      post_to_gui_thread([this, workspace_name, digest, stored_count]() {
+        auto known = _tab_digests.constFind(workspace_name);
+        if (known == _tab_digests.cend() || *known != digest) {
+          return;
+        }
+        _tab_digests.erase(known);
+        _workspaces[workspace_name].tab_count = stored_count;
+      });
+    };
+
+    // Loaded before the list row is overwritten: the head holds the ids of
+    // the previous version, which the new delta is computed against.
+    auto& head = tab_head(workspace_name);
+    auto count_changed = head.ids.size() != urls.size();
+
+    db.transaction();
+
+    QVector< qint64> ids;
+    ids.reserve(urls.size());
+    {
+      auto insert = _write_statements.acquire(Statement::INSERT_URL);
+      for (const auto& url : urls) {
+        auto it = _url_ids.constFind(url);
+        if (it != _url_ids.cend()) {
+          ids.append(*it);
+          continue;
+        }
 
-  _db.transaction();
+        insert->bindValue(0, url);
+        if (!insert->exec()) {
+          return fail("url insert", insert->lastError());
+        }
+        auto id = insert->lastInsertId().toLongLong();
+        _url_ids.insert(url, id);
+        interned.append(url);
+        ids.append(id);
+      }
+    }
 
-  QSqlQuery del(_db);
-  del.prepare("DELETE FROM workspace_tab WHERE workspace_name = ?");
-  del.addBindValue(workspace_name);
-  if (!del.exec()) {
-    qCWarning(logServer, "set_tabs: failed to delete tabs for '%s': %s",
-      qPrintable(workspace_name), qPrintable(del.lastError().text()));
-    _db.rollback();
-    return;
+    {
+      auto upsert = _write_statements.acquire(Statement::UPSERT_TAB_LIST);
+      upsert->bindValue(0, workspace_name);
+      upsert->bindValue(1, encode_varints(ids));
+      if (!upsert->exec()) {
+        return fail("tab list write", upsert->lastError());
+      }
+    }
+
+    {
+      auto keyframe = head.version == 0 || head.since_keyframe + 1 >= _tab_keyframe_interval;
+      auto version = head.version + 1;
+
+      auto insert = _write_statements.acquire(Statement::INSERT_TAB_VERSION);
+      insert->bindValue(0, workspace_name);
+      insert->bindValue(1, version);
+      insert->bindValue(2, QDateTime::currentMSecsSinceEpoch());
+      insert->bindValue(3, keyframe ? 1 : 0);
+      insert->bindValue(4, keyframe ? encode_varints(ids) : encode_tab_delta(head.ids, ids));
+      if (!insert->exec()) {
+        return fail("history write", insert->lastError());
+      }
+
+      if (keyframe && version > 1) {
+        // Pruning happens at keyframes only, which is where it can cut.
+        auto prune = _write_statements.acquire(Statement::PRUNE_TAB_VERSIONS);
+        prune->bindValue(0, workspace_name);
+        prune->bindValue(1, workspace_name);
+        prune->bindValue(2, QDateTime::currentMSecsSinceEpoch()
+          - std::chrono::duration_cast< std::chrono::milliseconds>(_tab_history_retention).count());
+        prune->bindValue(3, version - _tab_history_max_versions);
+        if (!prune->exec()) {
+          return fail("history prune", prune->lastError());
+        }
+      }
+
+      head.ids = ids;
+      head.version = version;
+      head.since_keyframe = keyframe ? 0 : head.since_keyframe + 1;
+    }
+
+    if (count_changed) {
+      auto count = _write_statements.acquire(Statement::SET_TAB_COUNT);
+      count->bindValue(0, static_cast< int>(urls.size()));
+      count->bindValue(1, workspace_name);
+      if (!count->exec()) {
+        return fail("tab count", count->lastError());
+      }
+    }
+
+    if (!db.commit()) {
+      fail("commit", db.lastError());
+    }
+  });
+  _tab_tickets.insert(workspace_name, _writer.submitted());
+}
+
+Workspace_db::Tab_head& Workspace_db::tab_head(const QString& workspace_name) {
+  auto it = _tab_heads.find(workspace_name);
+  if (it != _tab_heads.end()) {
+    return *it;
   }
 
-  QSqlQuery insert(_db);
-  insert.prepare(
-    "INSERT INTO workspace_tab (workspace_name, position, url)"
-    " VALUES (?, ?, ?)"
-  );
+  Tab_head head;
+  {
+    auto query = _write_statements.acquire(Statement::GET_TAB_IDS);
+    query->bindValue(0, workspace_name);
+    if (query->exec() && query->next()) {
+      head.ids = decode_varints(query->value(0).toByteArray()).value_or(QVector< qint64>());
+    }
+  }
+  {
+    auto query = _write_statements.acquire(Statement::GET_TAB_HEAD);
+    query->bindValue(0, workspace_name);
+    if (query->exec() && query->next() && !query->value(0).isNull()) {
+      head.version = query->value(0).toLongLong();
+      // A history without a keyframe cannot be extended by deltas.
+      head.since_keyframe = query->value(1).isNull()
+        ? _tab_keyframe_interval
+        : static_cast< int>(head.version - query->value(1).toLongLong());
+    }
+  }
+  return *_tab_heads.insert(workspace_name, head);
+}
 
-  bool ok = true;
-  for (int i = 0; i < urls.size(); ++i) {
-    insert.addBindValue(workspace_name);
-    insert.addBindValue(i);
-    insert.addBindValue(urls[i]);
-    if (!insert.exec()) {
-      qCWarning(logServer, "set_tabs: failed to insert tab %d for '%s': %s",
-        i, qPrintable(workspace_name), qPrintable(insert.lastError().text()));
-      ok = false;
-      break;
+QStringList Workspace_db::resolve_urls(
+  Statement_registry< Statement>& statements,
+  const QString& workspace_name,
+  const QVector< qint64>& ids
+) {
+  QStringList urls;
+  urls.reserve(ids.size());
+  auto query = statements.acquire(Statement::GET_URL);
+  for (auto id : ids) {
+    query->bindValue(0, id);
+    if (query->exec() && query->next()) {
+      urls.append(query->value(0).toString());
+    }
+    else {
+      qCWarning(logServer, "tab list of '%s' references missing url id %lld",
+        qPrintable(workspace_name), static_cast< long long>(id));
     }
   }
+  return urls;
+}
 
-  if (!ok) {
-    _db.rollback();
-    return;
+QStringList Workspace_db::read_tab_list(
+  Statement_registry< Statement>& statements, const QString& workspace_name
+) {
+  QByteArray blob;
+  {
+    auto query = statements.acquire(Statement::GET_TAB_IDS);
+    query->bindValue(0, workspace_name);
+    if (!query->exec()) {
+      qCWarning(logServer, "failed to read tabs of '%s': %s",
+        qPrintable(workspace_name), qPrintable(query->lastError().text()));
+      return {};
+    }
+    if (!query->next()) {
+      return {};
+    }
+    blob = query->value(0).toByteArray();
   }
 
-  _db.commit();
+  auto ids = decode_varints(blob);
+  if (!ids) {
+    qCWarning(logServer, "corrupt tab list for '%s' (%d bytes)",
+      qPrintable(workspace_name), static_cast< int>(blob.size()));
+    return {};
+  }
+  return resolve_urls(statements, workspace_name, *ids);
 }
 
-QStringList Workspace_db::get_tabs(const QString& workspace_name) const {
-  QStringList result;
-  QSqlQuery query(_db);
-  query.prepare(
-    "SELECT url FROM workspace_tab"
-    " WHERE workspace_name = ?"
-    " ORDER BY position"
-  );
-  query.addBindValue(workspace_name);
+std::optional< QStringList> Workspace_db::read_tab_list_at(
+  Statement_registry< Statement>& statements, const QString& workspace_name, qint64 ts_ms
+) {
+  QVector< qint64> ids;
+  int versions = 0;
+  {
+    auto query = statements.acquire(Statement::GET_TAB_VERSIONS_AT);
+    query->bindValue(0, workspace_name);
+    query->bindValue(1, ts_ms);
+    query->bindValue(2, workspace_name);
+    query->bindValue(3, workspace_name);
+    if (!query->exec()) {
+      qCWarning(logServer, "failed to read tab history of '%s': %s",
+        qPrintable(workspace_name), qPrintable(query->lastError().text()));
+      return std::nullopt;
+    }
 
-  if (query.exec()) {
-    while (query.next()) {
-      result.append(query.value(0).toString());
+    while (query->next()) {
+      auto data = query->value(1).toByteArray();
+      auto next = query->value(0).toBool()
+        ? decode_varints(data)
+        : apply_tab_delta(ids, data);
+      if (!next) {
+        qCWarning(logServer, "corrupt tab history for '%s' at step %d",
+          qPrintable(workspace_name), versions);
+        return std::nullopt;
+      }
+      ids = std::move(*next);
+      ++versions;
     }
   }
-  return result;
+
+  if (versions == 0) {
+    return std::nullopt;
+  }
+  return resolve_urls(statements, workspace_name, ids);
+}
+
+QStringList Workspace_db::get_tabs(const QString& workspace_name) const {
+  // Read-your-writes for this workspace only: blocks just while its last
+  // set_tabs() is still queued, never for a workspace without pending tabs.
+  _writer.wait_for(_tab_tickets.value(workspace_name));
+  return read_tab_list(_statements, workspace_name);
+}
+
+std::optional< QStringList> Workspace_db::get_tabs_at(const QString& workspace_name, qint64 ts_ms) const {
+  _writer.wait_for(_tab_tickets.value(workspace_name));
+  return read_tab_list_at(_statements, workspace_name, ts_ms);
+}
+
+void Workspace_db::get_tabs_async(
+  const QString& workspace_name,
+  std::function< void(const QStringList& urls)> done
+) const {
+  // The reader waits only for the workspace's tab writes issued so far.
+  auto ticket = _tab_tickets.value(workspace_name);
+
+  auto submitted = _readers.submit([this, workspace_name, done, ticket](QSqlDatabase&, int worker) {
+    _writer.wait_for(ticket);
+    done(read_tab_list(_reader_statements[worker], workspace_name));
+  });
+
+  if (!submitted) {
+    done(get_tabs(workspace_name));
+  }
+}
+
+void Workspace_db::get_tabs_at_async(
+  const QString& workspace_name,
+  qint64 ts_ms,
+  std::function< void(const std::optional< QStringList>& urls)> done
+) const {
+  auto ticket = _tab_tickets.value(workspace_name);
+
+  auto submitted = _readers.submit([this, workspace_name, ts_ms, done, ticket](QSqlDatabase&, int worker) {
+    _writer.wait_for(ticket);
+    done(read_tab_list_at(_reader_statements[worker], workspace_name, ts_ms));
+  });
+
+  if (!submitted) {
+    done(get_tabs_at(workspace_name, ts_ms));
+  }
 }
 
 // --- Claude status ---
@@ -400,114 +1421,237 @@ qint64 Workspace_db::set_claude_state(
   Claude_state state,
   const QString& tool_name,
   const QString& wait_reason,
-  const QString& wait_message
+  const QString& wait_message,
+  qint64 at_ms
 ) {
   ensure_workspace_exists(workspace);
 
-  auto now = QDateTime::currentMSecsSinceEpoch();
+  auto now = at_ms > 0 ? at_ms : QDateTime::currentMSecsSinceEpoch();
 
-  QSqlQuery query(_db);
-  query.prepare(
-    "INSERT INTO claude_session (workspace_name, state, tool_name, wait_reason, wait_message, state_since_ms)"
-    " VALUES (?, ?, ?, ?, ?, ?)"
-    " ON CONFLICT(workspace_name) DO UPDATE SET"
-    "   state = excluded.state,"
-    "   tool_name = excluded.tool_name,"
-    "   wait_reason = excluded.wait_reason,"
-    "   wait_message = excluded.wait_message,"
-    "   state_since_ms = excluded.state_since_ms"
-  );
-  query.addBindValue(workspace);
-  query.addBindValue(to_wire_string(state));
-  query.addBindValue(tool_name.isEmpty() ? QVariant() : tool_name);
-  query.addBindValue(wait_reason.isEmpty() ? QVariant() : wait_reason);
-  query.addBindValue(wait_message.isEmpty() ? QVariant() : wait_message);
-  query.addBindValue(now);
+  auto& status = _claude_sessions[workspace];
+  status.workspace_name = workspace;
+  status.state          = state;
+  status.tool_name      = tool_name;
+  status.wait_reason    = wait_reason;
+  status.wait_message   = wait_message;
+  status.state_since_ms = now;
 
-  if (!query.exec()) {
-    qCWarning(logClaude, "set_claude_state: failed for '%s': %s",
-      qPrintable(workspace), qPrintable(query.lastError().text()));
-    return -1;
-  }
+  queue_claude_write(status);
 
   return now;
 }
 
-qint64 Workspace_db::start_claude_session(const QString& workspace, const QString& session_id) {
+qint64 Workspace_db::start_claude_session(const QString& workspace, const QString& session_id, qint64 at_ms) {
   ensure_workspace_exists(workspace);
 
-  auto now = QDateTime::currentMSecsSinceEpoch();
+  auto now = at_ms > 0 ? at_ms : QDateTime::currentMSecsSinceEpoch();
 
-  QSqlQuery query(_db);
-  query.prepare(
-    "INSERT INTO claude_session (workspace_name, session_id, state, state_since_ms)"
-    " VALUES (?, ?, 'idle', ?)"
-    " ON CONFLICT(workspace_name) DO UPDATE SET"
-    "   session_id = excluded.session_id,"
-    "   state = 'idle',"
-    "   tool_name = NULL,"
-    "   wait_reason = NULL,"
-    "   wait_message = NULL,"
-    "   state_since_ms = excluded.state_since_ms"
-  );
-  query.addBindValue(workspace);
-  query.addBindValue(session_id);
-  query.addBindValue(now);
+  _claude_sessions[workspace] = Claude_workspace_status{
+    .workspace_name = workspace,
+    .state = Claude_state::IDLE,
+    .state_since_ms = now,
+    .session_id = session_id
+  };
 
-  if (!query.exec()) {
-    qCWarning(logClaude, "start_claude_session: failed for '%s': %s",
-      qPrintable(workspace), qPrintable(query.lastError().text()));
-    return -1;
+  queue_claude_write(_claude_sessions[workspace]);
+
+  return now;
+}
+
+qint64 Workspace_db::end_claude_session(const QString& workspace, qint64 at_ms) {
+  auto now = at_ms > 0 ? at_ms : QDateTime::currentMSecsSinceEpoch();
+
+  auto it = _claude_sessions.find(workspace);
+  if (it == _claude_sessions.end()) {
+    // No session row to end.
+    return now;
   }
+  *it = Claude_workspace_status{
+    .workspace_name = workspace,
+    .state = Claude_state::NOT_RUNNING,
+    .state_since_ms = now
+  };
+
+  queue_claude_write(*it);
 
   return now;
 }
 
-qint64 Workspace_db::end_claude_session(const QString& workspace) {
-  auto now = QDateTime::currentMSecsSinceEpoch();
+void Workspace_db::set_claude_commit_window(std::chrono::milliseconds window) {
+  _claude_commit_timer.setInterval(window);
+  if (window.count() == 0) {
+    commit_claude_writes();
+  }
+}
 
-  QSqlQuery query(_db);
-  query.prepare(
-    "UPDATE claude_session SET"
-    "  session_id = NULL,"
-    "  state = 'not_running',"
-    "  tool_name = NULL,"
-    "  wait_reason = NULL,"
-    "  wait_message = NULL,"
-    "  state_since_ms = ?"
-    " WHERE workspace_name = ?"
-  );
-  query.addBindValue(now);
-  query.addBindValue(workspace);
+void Workspace_db::begin_claude_batch() {
+  ++_claude_batch_depth;
+}
 
-  if (!query.exec()) {
-    qCWarning(logClaude, "end_claude_session: failed for '%s': %s",
-      qPrintable(workspace), qPrintable(query.lastError().text()));
-    return -1;
+void Workspace_db::end_claude_batch() {
+  if (_claude_batch_depth == 0 || --_claude_batch_depth > 0) {
+    return;
   }
+  commit_claude_writes();
+}
 
-  return now;
+void Workspace_db::queue_claude_write(const Claude_workspace_status& status) {
+  _pending_claude_events.append({_next_claude_seq++, status});
+  _unchecked_claude_sessions.insert(status.workspace_name);
+
+  if (_claude_batch_depth > 0) {
+    return;
+  }
+  if (_claude_commit_timer.interval() == 0) {
+    commit_claude_writes();
+  }
+  else if (!_claude_commit_timer.isActive()) {
+    // Not restarted on later writes, so a write waits at most one window.
+    _claude_commit_timer.start();
+  }
+}
+
+void Workspace_db::commit_claude_writes() {
+  _claude_commit_timer.stop();
+  if (_pending_claude_events.isEmpty()) {
+    return;
+  }
+
+  auto events = std::move(_pending_claude_events);
+  _pending_claude_events.clear();
+
+  _writer.submit("commit_claude_writes", [this, events](QSqlDatabase& db) {
+    db.transaction();
+
+    auto appended = true;
+    {
+      auto query = _write_statements.acquire(Statement::APPEND_CLAUDE_EVENT);
+      for (const auto& [seq, status] : events) {
+        query->bindValue(0, seq);
+        bind_claude_status(*query, 1, status);
+
+        if (!query->exec()) {
+          qCWarning(logClaude, "commit_claude_writes: failed to append event %lld for '%s': %s",
+            static_cast< long long>(seq), qPrintable(status.workspace_name),
+            qPrintable(query->lastError().text()));
+          appended = false;
+          break;
+        }
+      }
+    }
+
+    if (appended && db.commit()) {
+      return;
+    }
+    if (appended) {
+      qCWarning(logClaude, "commit_claude_writes: commit failed: %s",
+        qPrintable(db.lastError().text()));
+    }
+    db.rollback();
+
+    // The mirror already holds these states. Checkpointing them now covers
+    // the lost sequence numbers before any later entry can be replayed
+    // past them.
+    QSet< QString> workspaces;
+    for (const auto& event : events) {
+      workspaces.insert(event.second.workspace_name);
+    }
+    qCWarning(logClaude, "commit_claude_writes: dropped %d events, checkpointing %d workspaces",
+      static_cast< int>(events.size()), static_cast< int>(workspaces.size()));
+    post_to_gui_thread([this, workspaces]() {
+      _unchecked_claude_sessions.unite(workspaces);
+      checkpoint_claude_sessions();
+    });
+  });
+}
+
+void Workspace_db::checkpoint_claude_sessions() {
+  // Journal entries must reach the writer before the checkpoint that covers them.
+  commit_claude_writes();
+  if (_unchecked_claude_sessions.isEmpty()) {
+    return;
+  }
+
+  QVector< Claude_workspace_status> statuses;
+  statuses.reserve(_unchecked_claude_sessions.size());
+  for (const auto& name : _unchecked_claude_sessions) {
+    statuses.append(_claude_sessions.value(name));
+  }
+  auto workspaces = std::move(_unchecked_claude_sessions);
+  _unchecked_claude_sessions.clear();
+
+  auto checkpoint = _next_claude_seq - 1;
+  auto cutoff_ms = QDateTime::currentMSecsSinceEpoch()
+    - std::chrono::duration_cast< std::chrono::milliseconds>(_claude_event_retention).count();
+
+  _writer.submit("checkpoint_claude_sessions", [this, statuses, workspaces, checkpoint, cutoff_ms](QSqlDatabase& db) {
+    // Rolled back: the next start replays from the previous checkpoint, and
+    // the next checkpoint writes these rows again.
+    auto fail = [this, &db, &workspaces]() {
+      db.rollback();
+      post_to_gui_thread([this, workspaces]() {
+        _unchecked_claude_sessions.unite(workspaces);
+      });
+    };
+
+    db.transaction();
+
+    {
+      auto upsert = _write_statements.acquire(Statement::UPSERT_CLAUDE_SESSION);
+      for (const auto& status : statuses) {
+        bind_claude_status(*upsert, 0, status);
+        if (!upsert->exec()) {
+          qCWarning(logClaude, "checkpoint_claude_sessions: failed for '%s': %s",
+            qPrintable(status.workspace_name), qPrintable(upsert->lastError().text()));
+          upsert->finish();
+          return fail();
+        }
+      }
+    }
+
+    {
+      auto meta = _write_statements.acquire(Statement::SET_META);
+      meta->bindValue(0, QString::fromLatin1(_claude_checkpoint_key));
+      meta->bindValue(1, QString::number(checkpoint));
+      if (!meta->exec()) {
+        qCWarning(logClaude, "checkpoint_claude_sessions: failed to store checkpoint %lld: %s",
+          static_cast< long long>(checkpoint), qPrintable(meta->lastError().text()));
+        meta->finish();
+        return fail();
+      }
+    }
+
+    {
+      auto compact = _write_statements.acquire(Statement::COMPACT_CLAUDE_EVENTS);
+      compact->bindValue(0, checkpoint);
+      compact->bindValue(1, cutoff_ms);
+      compact->bindValue(2, checkpoint - _claude_event_max_rows);
+      if (!compact->exec()) {
+        qCWarning(logClaude, "checkpoint_claude_sessions: compaction failed: %s",
+          qPrintable(compact->lastError().text()));
+      }
+      else if (compact->numRowsAffected() > 0) {
+        qCInfo(logClaude, "compacted %d claude events up to checkpoint %lld",
+          compact->numRowsAffected(), static_cast< long long>(checkpoint));
+      }
+    }
+
+    if (!db.commit()) {
+      qCWarning(logClaude, "checkpoint_claude_sessions: commit of checkpoint %lld failed: %s",
+        static_cast< long long>(checkpoint), qPrintable(db.lastError().text()));
+      fail();
+    }
+  });
+}
+
+void Workspace_db::post_to_gui_thread(std::function< void()> task) {
+  QMetaObject::invokeMethod(&_gui_context, std::move(task), Qt::QueuedConnection);
 }
 
 QVector< Claude_workspace_status> Workspace_db::all_claude_statuses() const {
   QVector< Claude_workspace_status> result;
-  QSqlQuery query(_db);
-
-  if (query.exec(
-    "SELECT workspace_name, session_id, state, tool_name,"
-    " wait_reason, wait_message, state_since_ms"
-    " FROM claude_session"
-    " WHERE state != 'not_running'"
-  )) {
-    while (query.next()) {
-      Claude_workspace_status status;
-      status.workspace_name = query.value(0).toString();
-      status.session_id     = query.value(1).toString();
-      status.state          = parse_state(query.value(2).toString());
-      status.tool_name      = query.value(3).toString();
-      status.wait_reason    = query.value(4).toString();
-      status.wait_message   = query.value(5).toString();
-      status.state_since_ms = query.value(6).toLongLong();
+  for (const auto& status : _claude_sessions) {
+    if (status.state != Claude_state::NOT_RUNNING) {
       result.append(status);
     }
   }
@@ -515,52 +1659,32 @@ QVector< Claude_workspace_status> Workspace_db::all_claude_statuses() const {
 }
 
 std::optional< Claude_workspace_status> Workspace_db::claude_status(const QString& workspace) const {
-  QSqlQuery query(_db);
-  query.prepare(
-    "SELECT workspace_name, session_id, state, tool_name,"
-    " wait_reason, wait_message, state_since_ms"
-    " FROM claude_session"
-    " WHERE workspace_name = ?"
-  );
-  query.addBindValue(workspace);
-
-  if (query.exec() && query.next()) {
-    Claude_workspace_status status;
-    status.workspace_name = query.value(0).toString();
-    status.session_id     = query.value(1).toString();
-    status.state          = parse_state(query.value(2).toString());
-    status.tool_name      = query.value(3).toString();
-    status.wait_reason    = query.value(4).toString();
-    status.wait_message   = query.value(5).toString();
-    status.state_since_ms = query.value(6).toLongLong();
-    return status;
+  auto it = _claude_sessions.constFind(workspace);
+  if (it == _claude_sessions.cend()) {
+    return std::nullopt;
   }
-  return std::nullopt;
+  return *it;
 }
 
 // --- Meta ---
 
 QString Workspace_db::get_meta(const QString& key) const {
-  QSqlQuery query(_db);
-  query.prepare("SELECT value FROM meta WHERE key = ?");
-  query.addBindValue(key);
-
-  if (query.exec() && query.next()) {
-    return query.value(0).toString();
-  }
-  return {};
+  return _meta.value(key);
 }
 
 void Workspace_db::set_meta(const QString& key, const QString& value) {
-  QSqlQuery query(_db);
-  query.prepare("INSERT OR REPLACE INTO meta (key, value) VALUES (?, ?)");
-  query.addBindValue(key);
-  query.addBindValue(value);
+  _meta.insert(key, value);
 
-  if (!query.exec()) {
-    qCWarning(logServer, "set_meta: failed for key '%s': %s",
-      qPrintable(key), qPrintable(query.lastError().text()));
-  }
+  _writer.submit("set_meta", [this, key, value](QSqlDatabase&) {
+    auto query = _write_statements.acquire(Statement::SET_META);
+    query->bindValue(0, key);
+    query->bindValue(1, value);
+
+    if (!query->exec()) {
+      qCWarning(logServer, "set_meta: failed for key '%s': %s",
+        qPrintable(key), qPrintable(query->lastError().text()));
+    }
+  });
 }
 
 // --- Migration ---
@@ -571,9 +1695,7 @@ void Workspace_db::migrate_from_config_dir(const QString& config_dir) {
     return;
   }
 
-  QSqlQuery check(_db);
-  check.prepare("SELECT value FROM meta WHERE key = 'migration_completed'");
-  if (check.exec() && check.next()) {
+  if (!get_meta("migration_completed").isEmpty()) {
     return;
   }
 
@@ -616,10 +1738,5 @@ void Workspace_db::migrate_from_config_dir(const QString& config_dir) {
       qPrintable(name), qPrintable(project_dir));
   }
 
-  QSqlQuery mark(_db);
-  mark.prepare("INSERT OR REPLACE INTO meta (key, value) VALUES ('migration_completed', '1')");
-  if (!mark.exec()) {
-    qCWarning(logServer, "failed to mark migration as completed: %s",
-      qPrintable(mark.lastError().text()));
-  }
+  set_meta("migration_completed", "1");
 }
@@ -1,97 +1,156 @@
 #pragma once
 
+#include "db_reader_pool.h"
+#include "db_writer.h"
+#include "path_index.h"
+#include "statement_registry.h"
+#include "workspace_storage.h"
+
 #include <claude_types.h>
 
+#include <QByteArray>
+#include <QHash>
 #include <QJsonArray>
+#include <QObject>
+#include <QPair>
+#include <QSet>
 #include <QSqlDatabase>
 #include <QString>
 #include <QStringList>
+#include <QTimer>
 #include <QVector>
 
+#include <chrono>
+#include <functional>
+#include <mutex>
 #include <optional>
+#include <vector>
 
-struct Desktop_info {
-  int index;
-  QString name;
-  bool is_current;
-};
-
-struct Workspace_info {
-  QString name;
-  QString project_dir;
+/// WAL and idle maintenance counters, see Workspace_db::maintenance_stats().
+struct Db_maintenance_stats {
+  qint64 wal_bytes = 0;               ///< Current size of the -wal file
+  qint64 checkpoints = 0;             ///< Maintenance checkpoints run since start
+  qint64 forced_checkpoints = 0;      ///< Of those, run without idle time (WAL over limit)
+  qint64 last_checkpoint_us = 0;
+  qint64 max_checkpoint_us = 0;
+  qint64 last_checkpoint_wal_pages = 0;  ///< WAL frames before the last checkpoint
+  bool last_checkpoint_busy = false;  ///< Readers kept the last checkpoint from completing
+  qint64 vacuumed_pages = 0;          ///< Pages released by incremental_vacuum since start
 };
 
-/// Single point of access to the SQLite database.
+/// SQLite backend of Workspace_storage.
 /// All SQL is encapsulated here — the rest of the codebase uses only
-/// the public methods of this class.
-class Workspace_db {
+/// the Workspace_storage interface.
+///
+/// The workspace, claude_session and meta tables are mirrored in memory: they are
+/// loaded once at open time, reads are served from the mirror without SQL,
+/// and mutations update the mirror first and then persist to SQLite.
+/// Persistence is asynchronous: writes are queued to a Db_writer thread that
+/// owns a second connection, so WAL commits never run on the GUI thread.
+/// Reads that still need SQL can run on a Db_reader_pool of read-only
+/// connections instead of the GUI thread.
+///
+/// WAL auto-checkpointing is disabled: checkpoints and incremental vacuum run
+/// from run_maintenance() once the writer has been idle for a while.
+///
+/// Claude state changes are appended to the claude_event journal; the
+/// claude_session table is only a periodic checkpoint of the mirror, and
+/// events after the checkpoint are replayed at open time.
+class Workspace_db : public Workspace_storage {
  public:
   explicit Workspace_db(const QString& db_path);
-  ~Workspace_db();
+  ~Workspace_db() override;
 
   Workspace_db(const Workspace_db&) = delete;
   Workspace_db& operator =(const Workspace_db&) = delete;
 
   bool is_open() const;
 
-  // --- Workspaces ---
+  /// Block until all queued writes, including pending Claude state, are committed.
+  void flush() override;
+
+  /// Writer queue, reader and WAL maintenance counters as JSON.
+  QJsonObject storage_stats() const override;
 
-  /// Insert or update a workspace with its project directory.
-  void create_workspace(const QString& name, const QString& project_dir);
+  /// Writer queue depth and latency counters.
+  Db_writer_stats writer_stats() const;
 
-  /// @return project directory for the workspace, empty if not found.
-  QString get_project_dir(const QString& workspace_name) const;
+  Db_maintenance_stats maintenance_stats() const;
 
-  /// Find workspace whose project_dir is a prefix of @p path (longest match).
-  /// @return workspace name, empty if no match.
-  QString find_workspace_by_path(const QString& path) const;
+  // --- Workspaces ---
 
-  /// @return JSON array of all workspaces with name, project_dir, tab_count, is_active.
-  QJsonArray all_workspaces() const;
+  void create_workspace(const QString& name, const QString& project_dir) override;
+  QString get_project_dir(const QString& workspace_name) const override;
 
-  /// Update active desktop state from the window manager snapshot.
-  /// Marks matching workspaces as active, clears active flag for the rest.
-  void sync_active_desktops(const QVector< Desktop_info>& desktops);
+  /// Served from a path-component trie with an LRU cache in front of it.
+  QString find_workspace_by_path(const QString& path) const override;
 
-  QVector< Workspace_info> active_desktops() const;
-  QVector< Workspace_info> saved_workspaces() const;
+  QJsonArray all_workspaces() const override;
 
-  /// Swap desktop_index values for two active workspaces.
-  void swap_desktop_order(const QString& name_a, const QString& name_b);
+  /// Only rows that differ from the previous snapshot are written; an
+  /// unchanged snapshot costs no SQL.
+  void sync_active_desktops(const QVector< Desktop_info>& desktops) override;
 
-  /// @return name of the active desktop at given position in the internal
-  /// sorted order (0-based). Empty string if position is out of range.
-  QString active_desktop_name_at(int position) const;
+  QVector< Workspace_info> active_desktops() const override;
+  QVector< Workspace_info> saved_workspaces() const override;
+  void swap_desktop_order(const QString& name_a, const QString& name_b) override;
+  QString active_desktop_name_at(int position) const override;
 
   // --- Tabs ---
 
-  void set_tabs(const QString& workspace_name, const QStringList& urls);
-  QStringList get_tabs(const QString& workspace_name) const;
+  /// An unchanged list (same content digest) costs no SQL; otherwise the list
+  /// is written as a single row of interned URL ids, and the change is
+  /// recorded as a new history version (usually a few-byte delta).
+  void set_tabs(const QString& workspace_name, const QStringList& urls) override;
+
+  /// Blocks only while this workspace's last set_tabs() is still queued.
+  QStringList get_tabs(const QString& workspace_name) const override;
+
+  /// Runs on a reader thread. Falls back to get_tabs() on the calling
+  /// thread when the reader pool is unavailable.
+  void get_tabs_async(
+    const QString& workspace_name,
+    std::function< void(const QStringList& urls)> done
+  ) const override;
+
+  /// Rebuilds the list from the nearest keyframe and its deltas; blocks
+  /// like get_tabs().
+  std::optional< QStringList> get_tabs_at(const QString& workspace_name, qint64 ts_ms) const override;
+
+  /// Rebuilds the list from the nearest keyframe and its deltas on a reader thread.
+  void get_tabs_at_async(
+    const QString& workspace_name,
+    qint64 ts_ms,
+    std::function< void(const std::optional< QStringList>& urls)> done
+  ) const override;
 
   // --- Claude status ---
 
-  /// Set Claude state for a workspace. Returns the state_since_ms written to DB.
   qint64 set_claude_state(
     const QString& workspace,
     Claude_state state,
-    const QString& tool_name = {},
-    const QString& wait_reason = {},
-    const QString& wait_message = {}
-  );
+    const QString& tool_name,
+    const QString& wait_reason,
+    const QString& wait_message,
+    qint64 at_ms
+  ) override;
+  qint64 start_claude_session(const QString& workspace, const QString& session_id, qint64 at_ms) override;
+  qint64 end_claude_session(const QString& workspace, qint64 at_ms) override;
+  void begin_claude_batch() override;
+  void end_claude_batch() override;
 
-  /// Start a new Claude session. Returns the state_since_ms written to DB.
-  qint64 start_claude_session(const QString& workspace, const QString& session_id);
+  /// Claude state changes are group-committed: events journaled within
+  /// @p window are appended in one transaction.
+  /// A zero window writes every change immediately.
+  void set_claude_commit_window(std::chrono::milliseconds window);
 
-  /// End the Claude session. Returns the state_since_ms written to DB.
-  qint64 end_claude_session(const QString& workspace);
-
-  QVector< Claude_workspace_status> all_claude_statuses() const;
-  std::optional< Claude_workspace_status> claude_status(const QString& workspace) const;
+  QVector< Claude_workspace_status> all_claude_statuses() const override;
+  std::optional< Claude_workspace_status> claude_status(const QString& workspace) const override;
 
   // --- Meta ---
 
-  QString get_meta(const QString& key) const;
-  void set_meta(const QString& key, const QString& value);
+  QString get_meta(const QString& key) const override;
+  void set_meta(const QString& key, const QString& value) override;
 
   // --- Migration ---
 
@@ -100,10 +159,191 @@ class Workspace_db {
   void migrate_from_config_dir(const QString& config_dir);
 
  private:
-  void create_tables();
+  /// Every statement used by this class, prepared once in prepare_statements().
+  enum class Statement {
+    ENSURE_WORKSPACE,
+    CREATE_WORKSPACE,
+    DEACTIVATE_DESKTOP,
+    UPSERT_ACTIVE_DESKTOP,
+    SET_SORT_ORDER,
+    GET_TAB_IDS,
+    GET_URL,
+    INSERT_URL,
+    UPSERT_TAB_LIST,
+    GET_TAB_HEAD,
+    INSERT_TAB_VERSION,
+    PRUNE_TAB_VERSIONS,
+    GET_TAB_VERSIONS_AT,
+    SET_TAB_COUNT,
+    UPSERT_CLAUDE_SESSION,
+    APPEND_CLAUDE_EVENT,
+    COMPACT_CLAUDE_EVENTS,
+    SET_META
+  };
+
+  /// In-memory copy of a workspace table row.
+  struct Workspace_row {
+    QString project_dir;
+    bool is_active = false;
+    std::optional< int> desktop_index;
+    std::optional< int> sort_order;
+    /// Maintained in the workspace.tab_count column by set_tabs.
+    int tab_count = 0;
+  };
+
+  /// Bring the schema up to date: runs every migration newer than
+  /// PRAGMA user_version, see schema_migrations in the .cpp.
+  void migrate_schema();
+
+  /// Note whether the file still needs the switch to auto_vacuum=INCREMENTAL.
+  void check_auto_vacuum();
+
+  /// The switch itself: one full VACUUM, run by the first idle maintenance.
+  /// Writer thread only.
+  static void enable_incremental_vacuum(QSqlDatabase& db);
+
+  /// Checkpoint the WAL and release free pages if the writer is idle, or
+  /// checkpoint regardless once the WAL outgrows _wal_force_checkpoint_bytes.
+  void run_maintenance();
+  qint64 wal_bytes() const;
+  void prepare_read_statements();
+  void prepare_reader_statements(const QSqlDatabase& db, int worker);
+  void prepare_write_statements(const QSqlDatabase& db);
+  void load_mirror();
+
+  /// Seed _tab_digests from the stored tab lists (the head of each
+  /// workspace's history), so an unchanged save after start costs no SQL.
+  void load_tab_digests();
+
+  /// Fill _url_ids from url_dictionary, dropping urls no tab list references.
+  /// Runs on the writer thread.
+  void load_url_dictionary(QSqlDatabase& db);
+
+  /// Resolve a workspace's tab list through @p statements (GET_TAB_IDS, GET_URL).
+  static QStringList read_tab_list(
+    Statement_registry< Statement>& statements, const QString& workspace_name);
+  static std::optional< QStringList> read_tab_list_at(
+    Statement_registry< Statement>& statements, const QString& workspace_name, qint64 ts_ms);
+  static QStringList resolve_urls(
+    Statement_registry< Statement>& statements,
+    const QString& workspace_name,
+    const QVector< qint64>& ids);
+
+  /// Latest tab history version of a workspace as known to the writer.
+  struct Tab_head {
+    QVector< qint64> ids;
+    qint64 version = 0;          ///< 0: no history yet
+    int since_keyframe = 0;      ///< Deltas written after the last keyframe
+  };
+
+  /// Cached head of @p workspace_name, loaded on first use. Writer thread only.
+  Tab_head& tab_head(const QString& workspace_name);
   void ensure_workspace_exists(const QString& name);
 
+  /// Recompute _active_order and _saved_order from _workspaces.
+  void rebuild_order();
+
+  static QByteArray tab_digest(const QStringList& urls);
+
+  /// Apply journal entries newer than the last checkpoint to the mirror.
+  void replay_claude_events();
+
+  void queue_claude_write(const Claude_workspace_status& status);
+
+  /// Append the pending journal entries in one writer transaction. A failed
+  /// batch is rolled back whole and its workspaces are checkpointed from the
+  /// mirror at once, so replay never runs over the gap it leaves.
+  void commit_claude_writes();
+
+  /// Write the mirror rows changed since the last checkpoint to
+  /// claude_session, record the checkpointed sequence number and drop
+  /// journal entries past retention. Rows of a failed checkpoint are
+  /// written again by the next one.
+  void checkpoint_claude_sessions();
+
+  /// Run @p task on the GUI thread, for writer jobs that report back to the mirror.
+  void post_to_gui_thread(std::function< void()> task);
+
   static constexpr const char* _connection_name = "workspace_db";
+  static constexpr const char* _writer_connection_name = "workspace_db_writer";
+  static constexpr std::size_t _writer_queue_capacity = 1024;
+  static constexpr const char* _reader_connection_prefix = "workspace_db_reader";
+  static constexpr int _reader_count = 2;
+  static constexpr auto _default_claude_commit_window = std::chrono::milliseconds(50);
+  static constexpr auto _claude_checkpoint_interval = std::chrono::minutes(1);
+  static constexpr auto _claude_event_retention = std::chrono::hours(24 * 30);
+  /// Upper bound on journal rows kept after a checkpoint, regardless of age.
+  static constexpr qint64 _claude_event_max_rows = 100000;
+  static constexpr const char* _claude_checkpoint_key = "claude_checkpoint_seq";
+  /// Every n-th tab version is a full keyframe; the rest are deltas.
+  static constexpr int _tab_keyframe_interval = 32;
+  static constexpr auto _tab_history_retention = std::chrono::hours(24 * 30);
+  static constexpr qint64 _tab_history_max_versions = 1000;
 
+  static constexpr auto _maintenance_check_interval = std::chrono::seconds(15);
+  static constexpr auto _maintenance_idle_after = std::chrono::seconds(10);
+  /// WAL size above which an idle checkpoint also truncates the file.
+  static constexpr qint64 _wal_truncate_bytes = 4 * 1024 * 1024;
+  /// WAL size above which a checkpoint runs even without idle time.
+  static constexpr qint64 _wal_force_checkpoint_bytes = 64 * 1024 * 1024;
+  static constexpr int _vacuum_pages_per_run = 256;
+
+  /// GUI thread connection: schema setup, initial load and remaining reads.
   QSqlDatabase _db;
+  mutable Statement_registry< Statement> _statements;
+
+  /// Statements of the writer connection, touched only on the writer thread.
+  Statement_registry< Statement> _write_statements;
+  /// Receiver of post_to_gui_thread() tasks. Declared before _writer, which
+  /// may still post while it drains.
+  QObject _gui_context;
+
+  /// url_dictionary cache of the writer thread: url -> id.
+  QHash< QString, qint64> _url_ids;
+  /// Tab history heads of the writer thread.
+  QHash< QString, Tab_head> _tab_heads;
+  mutable Db_writer _writer;
+
+  /// Statements of each reader connection, touched only on that worker.
+  mutable std::vector< Statement_registry< Statement>> _reader_statements;
+  /// Declared after _writer: readers wait on it and are joined first.
+  mutable Db_reader_pool _readers;
+
+  QHash< QString, Workspace_row> _workspaces;
+  QHash< QString, Claude_workspace_status> _claude_sessions;
+  /// project_dir of every workspace, for find_workspace_by_path().
+  Path_index _path_index;
+  /// Digest of the tab list last written per workspace, see tab_digest().
+  QHash< QString, QByteArray> _tab_digests;
+  /// _writer.submitted() right after the last set_tabs() job of each
+  /// workspace: tab reads wait for exactly that write, not for the whole queue.
+  QHash< QString, std::uint64_t> _tab_tickets;
+  /// meta table rows as set through set_meta(). The writer's own checkpoint
+  /// key is not followed after open.
+  QHash< QString, QString> _meta;
+
+  /// Active workspace names ordered by COALESCE(sort_order, desktop_index).
+  QStringList _active_order;
+  /// Inactive workspace names ordered by name.
+  QStringList _saved_order;
+
+  /// Journal entries not yet handed to the writer, in sequence order.
+  QVector< QPair< qint64, Claude_workspace_status>> _pending_claude_events;
+  QTimer _claude_commit_timer;
+  qint64 _next_claude_seq = 1;
+  /// Open begin_claude_batch() calls; commits wait until the last one ends.
+  int _claude_batch_depth = 0;
+
+  /// Workspaces whose mirror row differs from the last claude_session checkpoint.
+  QSet< QString> _unchecked_claude_sessions;
+  QTimer _claude_checkpoint_timer;
+
+  QTimer _maintenance_timer;
+  /// _writer.submitted() right after the last maintenance run.
+  std::uint64_t _maintained_at = 0;
+  /// The file is not in auto_vacuum=INCREMENTAL yet, see check_auto_vacuum().
+  bool _auto_vacuum_pending = false;
+  /// Written by the writer thread, read by maintenance_stats().
+  mutable std::mutex _maintenance_mutex;
+  Db_maintenance_stats _maintenance_stats;
 };
@@ -1,12 +1,14 @@
 #include "workspace_manager_dbus.h"
 #include "journal_log.h"
-#include "workspace_db.h"
+#include "workspace_storage.h"
 
 #include <QDBusConnection>
 #include <QDBusError>
+#include <QDBusMessage>
 #include <QJsonDocument>
+#include <QJsonObject>
 
-Workspace_manager_dbus::Workspace_manager_dbus(Workspace_db& db, QObject* parent)
+Workspace_manager_dbus::Workspace_manager_dbus(Workspace_storage& db, QObject* parent)
   : QDBusAbstractAdaptor(parent)
   , _db(db)
 {
@@ -50,5 +52,72 @@ void Workspace_manager_dbus::SetTabs(const QString& workspace_name, const QStrin
 }
 
 QString Workspace_manager_dbus::GetTabs(const QString& workspace_name) {
-  return _db.get_tabs(workspace_name).join('\n');
+  if (!calledFromDBus()) {
+    return _db.get_tabs(workspace_name).join('\n');
+  }
+
+  setDelayedReply(true);
+  auto reply_to = message();
+  auto bus = connection();
+  _db.get_tabs_async(workspace_name, [reply_to, bus](const QStringList& urls) {
+    // QDBusConnection::send is thread-safe
+    bus.send(reply_to.createReply(urls.join('\n')));
+  });
+  return {};
+}
+
+QString Workspace_manager_dbus::GetTabsAt(const QString& workspace_name, qlonglong timestamp_ms) {
+  if (!calledFromDBus()) {
+    auto urls = _db.get_tabs_at(workspace_name, timestamp_ms);
+    return urls ? urls->join('\n') : QString();
+  }
+
+  setDelayedReply(true);
+  auto reply_to = message();
+  auto bus = connection();
+  _db.get_tabs_at_async(workspace_name, timestamp_ms,
+    [reply_to, bus](const std::optional< QStringList>& urls) {
+      bus.send(urls
+        ? reply_to.createReply(urls->join('\n'))
+        : reply_to.createErrorReply(QDBusError::InvalidArgs, "no tab version at or before timestamp"));
+    });
+  return {};
+}
+
+QString Workspace_manager_dbus::RestoreTabsAt(const QString& workspace_name, qlonglong timestamp_ms) {
+  if (!calledFromDBus()) {
+    auto urls = _db.get_tabs_at(workspace_name, timestamp_ms);
+    if (!urls) {
+      qCWarning(logServer, "no tab version of '%s' at or before %lld to restore",
+        qPrintable(workspace_name), static_cast< long long>(timestamp_ms));
+      return {};
+    }
+    _db.set_tabs(workspace_name, *urls);
+    return urls->join('\n');
+  }
+
+  setDelayedReply(true);
+  auto reply_to = message();
+  auto bus = connection();
+  _db.get_tabs_at_async(workspace_name, timestamp_ms,
+    [this, workspace_name, reply_to, bus](const std::optional< QStringList>& urls) {
+      if (!urls) {
+        bus.send(reply_to.createErrorReply(QDBusError::InvalidArgs,
+          "no tab version at or before timestamp"));
+        return;
+      }
+
+      // Storage mutations belong to the GUI thread.
+      QMetaObject::invokeMethod(this, [this, workspace_name, restored = *urls, reply_to, bus]() {
+        qCInfo(logServer, "restoring %d tabs of '%s'",
+          static_cast< int>(restored.size()), qPrintable(workspace_name));
+        _db.set_tabs(workspace_name, restored);
+        bus.send(reply_to.createReply(restored.join('\n')));
+      }, Qt::QueuedConnection);
+    });
+  return {};
+}
+
+QString Workspace_manager_dbus::GetDbStats() {
+  return QJsonDocument(_db.storage_stats()).toJson(QJsonDocument::Compact);
 }
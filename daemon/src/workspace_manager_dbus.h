@@ -1,19 +1,23 @@
 #pragma once
 
 #include <QDBusAbstractAdaptor>
+#include <QDBusContext>
 #include <QString>
 
-class Workspace_db;
+class Workspace_storage;
 
 /// D-Bus adaptor exposing workspace management on org.workspace.Manager /Manager.
 /// Replaces file-based state storage — clients use D-Bus instead of reading
 /// ~/.config/workspaces/ files directly.
-class Workspace_manager_dbus : public QDBusAbstractAdaptor {
+///
+/// Lookups answered from memory reply inline. Tab reads
+/// still need SQL, so they reply later from a database reader thread.
+class Workspace_manager_dbus : public QDBusAbstractAdaptor, protected QDBusContext {
   Q_OBJECT
   Q_CLASSINFO("D-Bus Interface", "org.workspace.Manager")
 
  public:
-  Workspace_manager_dbus(Workspace_db& db, QObject* parent);
+  Workspace_manager_dbus(Workspace_storage& db, QObject* parent);
 
  public slots:
   void CreateWorkspace(const QString& name, const QString& project_dir);
@@ -21,8 +25,27 @@ class Workspace_manager_dbus : public QDBusAbstractAdaptor {
   QString FindWorkspaceByPath(const QString& path);
   QString ListWorkspaces();
   void SetTabs(const QString& workspace_name, const QString& urls);
+  /// Delayed reply: the result is sent from a database reader thread.
   QString GetTabs(const QString& workspace_name);
 
+  /// Tabs as they were stored at @p timestamp_ms (epoch ms), from the tab
+  /// history. Replies with an error if no version that old is retained;
+  /// called in-process, reads synchronously and returns empty instead.
+  QString GetTabsAt(const QString& workspace_name, qlonglong timestamp_ms);
+
+  /// Make the tab list stored at @p timestamp_ms current again (recorded as
+  /// a new version, so the restore itself can be undone).
+  /// @return the restored list, newline-separated.
+  QString RestoreTabsAt(const QString& workspace_name, qlonglong timestamp_ms);
+
+  /// Returns JSON object with storage statistics. Always has "backend";
+  /// the SQLite backend adds writer queue and WAL maintenance counters:
+  /// {queue_depth, queue_max_depth, queue_capacity, executed, blocked_submits,
+  ///  last_latency_us, max_latency_us, avg_latency_us, wal_bytes, checkpoints,
+  ///  forced_checkpoints, last_checkpoint_us, max_checkpoint_us,
+  ///  last_checkpoint_wal_pages, last_checkpoint_busy, vacuumed_pages}
+  QString GetDbStats();
+
  private:
-  Workspace_db& _db;
+  Workspace_storage& _db;
 };
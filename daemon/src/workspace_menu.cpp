@@ -1,9 +1,9 @@
 #include "workspace_menu.h"
 #include "desktop_monitor.h"
 #include "journal_log.h"
-#include "workspace_db.h"
+#include "workspace_storage.h"
 
-Workspace_menu::Workspace_menu(Workspace_db& db, Desktop_monitor& desktop_monitor, QObject* parent)
+Workspace_menu::Workspace_menu(Workspace_storage& db, Desktop_monitor& desktop_monitor, QObject* parent)
   : QObject(parent)
   , _db(db)
   , _desktop_monitor(desktop_monitor)
@@ -8,7 +8,7 @@
 #include <QPair>
 
 class Desktop_monitor;
-class Workspace_db;
+class Workspace_storage;
 
 class Workspace_menu : public QObject {
   Q_OBJECT
@@ -16,7 +16,7 @@ class Workspace_menu : public QObject {
   Q_PROPERTY(Workspace_model* model READ model CONSTANT)
 
  public:
-  explicit Workspace_menu(Workspace_db& db, Desktop_monitor& desktop_monitor, QObject* parent = nullptr);
+  explicit Workspace_menu(Workspace_storage& db, Desktop_monitor& desktop_monitor, QObject* parent = nullptr);
 
   void begin_session();
 
@@ -39,7 +39,7 @@ class Workspace_menu : public QObject {
   void load_data();
   void rebuild_model();
 
-  Workspace_db& _db;
+  Workspace_storage& _db;
   Desktop_monitor& _desktop_monitor;
   QString _filter_text;
 
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <claude_types.h>
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+#include <optional>
+
+struct Desktop_info {
+  int index;
+  QString name;
+};
+
+struct Workspace_info {
+  QString name;
+  QString project_dir;
+};
+
+/// Storage of workspaces, tabs, Claude status and settings.
+/// The daemon's components depend only on this interface; Workspace_db
+/// persists to SQLite, Memory_storage keeps everything in process memory
+/// (for stress runs without disk I/O, see WORKSPACE_STORAGE in main.cpp).
+///
+/// All methods are called on the GUI thread, except that the callbacks of
+/// the *_async methods may run on a storage thread.
+class Workspace_storage {
+ public:
+  virtual ~Workspace_storage() = default;
+
+  /// Block until all accepted writes are durable.
+  virtual void flush() = 0;
+
+  /// Backend-specific counters, reported by GetDbStats.
+  virtual QJsonObject storage_stats() const = 0;
+
+  // --- Workspaces ---
+
+  /// Insert or update a workspace with its project directory.
+  virtual void create_workspace(const QString& name, const QString& project_dir) = 0;
+
+  /// @return project directory for the workspace, empty if not found.
+  virtual QString get_project_dir(const QString& workspace_name) const = 0;
+
+  /// Find workspace whose project_dir is a prefix of @p path (longest match).
+  /// @return workspace name, empty if no match.
+  virtual QString find_workspace_by_path(const QString& path) const = 0;
+
+  /// @return JSON array of all workspaces with name, project_dir, tab_count, is_active.
+  virtual QJsonArray all_workspaces() const = 0;
+
+  /// Update active desktop state from the window manager snapshot.
+  /// Marks matching workspaces as active, clears active flag for the rest.
+  virtual void sync_active_desktops(const QVector< Desktop_info>& desktops) = 0;
+
+  virtual QVector< Workspace_info> active_desktops() const = 0;
+  virtual QVector< Workspace_info> saved_workspaces() const = 0;
+
+  /// Swap desktop_index values for two active workspaces.
+  virtual void swap_desktop_order(const QString& name_a, const QString& name_b) = 0;
+
+  /// @return name of the active desktop at given position in the internal
+  /// sorted order (0-based). Empty string if position is out of range.
+  virtual QString active_desktop_name_at(int position) const = 0;
+
+  // --- Tabs ---
+
+  /// Replace the stored tab list of a workspace; every change is kept as a
+  /// history version.
+  virtual void set_tabs(const QString& workspace_name, const QStringList& urls) = 0;
+  virtual QStringList get_tabs(const QString& workspace_name) const = 0;
+
+  /// Read the tab list and pass it to @p done, possibly on another thread.
+  /// Sees every set_tabs() issued before the call.
+  virtual void get_tabs_async(
+    const QString& workspace_name,
+    std::function< void(const QStringList& urls)> done
+  ) const = 0;
+
+  /// Tab list as it was stored at @p ts_ms (epoch ms), nullopt if no
+  /// version that old is retained.
+  virtual std::optional< QStringList> get_tabs_at(const QString& workspace_name, qint64 ts_ms) const = 0;
+
+  /// get_tabs_at() passed to @p done, possibly on another thread.
+  virtual void get_tabs_at_async(
+    const QString& workspace_name,
+    qint64 ts_ms,
+    std::function< void(const std::optional< QStringList>& urls)> done
+  ) const = 0;
+
+  // --- Claude status ---
+
+  /// Set Claude state for a workspace, begun at @p at_ms (epoch ms, 0 for
+  /// now). Returns the state_since_ms stored.
+  virtual qint64 set_claude_state(
+    const QString& workspace,
+    Claude_state state,
+    const QString& tool_name = {},
+    const QString& wait_reason = {},
+    const QString& wait_message = {},
+    qint64 at_ms = 0
+  ) = 0;
+
+  /// Start a new Claude session at @p at_ms (0 for now). Returns the state_since_ms stored.
+  virtual qint64 start_claude_session(const QString& workspace, const QString& session_id, qint64 at_ms = 0) = 0;
+
+  /// End the Claude session at @p at_ms (0 for now). Returns the state_since_ms stored.
+  virtual qint64 end_claude_session(const QString& workspace, qint64 at_ms = 0) = 0;
+
+  /// Claude state changes between begin_claude_batch() and the matching
+  /// end_claude_batch() are persisted in one transaction. Nestable.
+  virtual void begin_claude_batch() = 0;
+  virtual void end_claude_batch() = 0;
+
+  virtual QVector< Claude_workspace_status> all_claude_statuses() const = 0;
+  virtual std::optional< Claude_workspace_status> claude_status(const QString& workspace) const = 0;
+
+  // --- Meta ---
+
+  virtual QString get_meta(const QString& key) const = 0;
+  virtual void set_meta(const QString& key, const QString& value) = 0;
+};
@@ -1,23 +1,31 @@
 #!/usr/bin/env bash
 # Claude Code hook script for workspace status monitoring.
-# Reads JSON from stdin, determines workspace from cwd via D-Bus, sends status via D-Bus.
+# Reads JSON from stdin and sends the event with its cwd via D-Bus; the daemon
+# resolves the workspace.
 # Configured as async hook in ~/.claude/settings.json for all relevant events.
+# ~/.local/bin/claude-status-hook (daemon/src/claude_hook_main.cpp) does the same
+# without forking jq/qdbus and can be configured in its place.
 
 set -euo pipefail
 
+# Event time, taken first: hooks run concurrently and may reach the daemon
+# out of order; it orders the session's events. EPOCHREALTIME (bash 5) needs
+# no fork; without it 0 sends no time.
+event_time_us="${EPOCHREALTIME:-0}"
+event_time_us="${event_time_us/[.,]/}"
+event_time_ms=$(( event_time_us / 1000 ))
+
 SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 source "$SCRIPT_DIR/claude_constants.sh"
 
-MANAGER_SERVICE="org.workspace.Manager"
-MANAGER_PATH="/Manager"
-MANAGER_IFACE="org.workspace.Manager"
-
 STATUS_SERVICE="org.workspace.StatusMonitor"
 STATUS_PATH="/StatusMonitor"
 STATUS_IFACE="org.workspace.StatusMonitor"
 
 # Read JSON from stdin and extract all needed fields in a single jq call.
-IFS=$'\t' read -r hook_event_name cwd tool_name notification_type notification_message session_id < <(
+# Fields are joined with the unit separator: unlike tab it is not IFS
+# whitespace, so empty fields keep their position.
+IFS=$'\x1f' read -r hook_event_name cwd tool_name notification_type notification_message session_id < <(
   jq -r '[
     (.hook_event_name // ""),
     (.cwd // ""),
@@ -25,20 +33,13 @@ IFS=$'\t' read -r hook_event_name cwd tool_name notification_type notification_m
     (.notification.type // ""),
     (.notification.message // ""),
     (.session_id // "")
-  ] | @tsv' 2>/dev/null || printf '\t\t\t\t\t\n'
+  ] | map(gsub("[\t\n\u001f]"; " ")) | join("\u001f")' 2>/dev/null || printf '\x1f\x1f\x1f\x1f\x1f\n'
 )
 
 if [[ -z "$hook_event_name" || -z "$cwd" ]]; then
   exit 0
 fi
 
-# Determine workspace name by matching cwd against workspace project_dir entries via D-Bus
-workspace=$(qdbus "$MANAGER_SERVICE" "$MANAGER_PATH" "${MANAGER_IFACE}.FindWorkspaceByPath" "$cwd" 2>/dev/null) || exit 0
-
-if [[ -z "$workspace" ]]; then
-  exit 0
-fi
-
 # Build the event type and args based on hook event, then send via D-Bus.
 event_type=""
 args_tsv=""
@@ -64,7 +65,7 @@ case "$hook_event_name" in
         args_tsv="${notification_type}"
         ;;
       *)
-        logger -t claude-hook "unknown notification type '$notification_type' for workspace '$workspace'"
+        logger -t claude-hook "unknown notification type '$notification_type' for cwd '$cwd'"
         exit 0
         ;;
     esac
@@ -74,7 +75,29 @@ case "$hook_event_name" in
     ;;
   SessionStart)
     event_type="$CLAUDE_EVENT_SESSION_START"
-    args_tsv="${session_id:-unknown}"
+    # The agent's PID, for the daemon to notice its exit: Claude Code may run
+    # the hook through a shell, so skip shell ancestors. Name and PPid come
+    # from /proc/<pid>/status, as in the native hook. 0 if no non-shell
+    # ancestor is found within four levels; the daemon then uses its timeout.
+    agent_pid=0
+    pid=$PPID
+    for _ in 1 2 3 4; do
+      (( pid > 1 )) || break
+      name=""
+      parent=0
+      while read -r key value; do
+        case "$key" in
+          Name:) name=$value ;;
+          PPid:) parent=$value; break ;;
+        esac
+      done < "/proc/$pid/status" 2>/dev/null || true
+      [[ -n "$name" ]] || break
+      case "$name" in
+        sh|bash|dash|zsh) pid=$parent ;;
+        *) agent_pid=$pid; break ;;
+      esac
+    done
+    args_tsv="${session_id:-unknown}"$'\t'"${agent_pid}"
     ;;
   SessionEnd)
     event_type="$CLAUDE_EVENT_SESSION_END"
@@ -88,5 +111,19 @@ if [[ -z "$event_type" ]]; then
   exit 0
 fi
 
-qdbus "$STATUS_SERVICE" "$STATUS_PATH" "${STATUS_IFACE}.ReportClaudeEvent" \
-  "$workspace" "$event_type" "$args_tsv" 2>/dev/null || true
+# Every event but SessionStart names its session after its own args; the idle
+# prompt notification leaves its message empty to keep the position.
+case "$hook_event_name" in
+  SessionStart) ;;
+  PreToolUse) args_tsv="${args_tsv}"$'\t'"${session_id}" ;;
+  Notification)
+    if [[ "$notification_type" == "$CLAUDE_NOTIFICATION_IDLE_PROMPT" ]]; then
+      args_tsv="${args_tsv}"$'\t'
+    fi
+    args_tsv="${args_tsv}"$'\t'"${session_id}"
+    ;;
+  *) args_tsv="${session_id}" ;;
+esac
+
+qdbus "$STATUS_SERVICE" "$STATUS_PATH" "${STATUS_IFACE}.ReportClaudeEventForPathAt" \
+  "$cwd" "$event_type" "$args_tsv" "$event_time_ms" 2>/dev/null || true
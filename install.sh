@@ -153,6 +153,9 @@ fi
 cp "$BUILD_DIR/workspace-menu" "$HOME/.local/bin/workspace-menu"
 chmod +x "$HOME/.local/bin/workspace-menu"
 echo "  Daemon installed to ~/.local/bin/workspace-menu"
+cp "$BUILD_DIR/claude-status-hook" "$HOME/.local/bin/claude-status-hook"
+chmod +x "$HOME/.local/bin/claude-status-hook"
+echo "  Hook client installed to ~/.local/bin/claude-status-hook"
 DISPLAY="${DISPLAY:-:0}" nohup "$HOME/.local/bin/workspace-menu" > /dev/null 2>&1 &
 disown
 echo "  Daemon started (PID $!)"
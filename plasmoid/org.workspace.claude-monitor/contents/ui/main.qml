@@ -82,6 +82,14 @@ ColumnLayout {
       if (elapsed < 60) text += "\nDuration: " + elapsed + "s";
       else text += "\nDuration: " + Math.floor(elapsed / 60) + "m " + (elapsed % 60) + "s";
     }
+    if (status.sessions && status.sessions.length > 1) {
+      text += "\nSessions: " + status.sessions.length;
+      for (var i = 0; i < status.sessions.length; ++i) {
+        var session = status.sessions[i];
+        text += "\n  " + session.session_id.substring(0, 8) + ": " + session.state;
+        if (session.tool_name) text += " [" + session.tool_name + "]";
+      }
+    }
     return text;
   }
 }
@@ -12,6 +12,24 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 
+/// Per-session breakdown from GetAllStatuses JSON (as a variant list) or a
+/// StatusesChanged entry (D-Bus marshalled av of a{sv}).
+static QVector< Claude_session_status> parse_sessions(const QVariant& value) {
+  QVector< Claude_session_status> sessions;
+  for (const auto& element : qdbus_cast< QVariantList>(value)) {
+    auto session = qdbus_cast< QVariantMap>(element);
+    sessions.append(Claude_session_status{
+      .session_id = session["session_id"].toString(),
+      .state = from_wire_string< Claude_state>(session["state"].toString()).value_or(Claude_state::IDLE),
+      .tool_name = session["tool_name"].toString(),
+      .wait_reason = session["wait_reason"].toString(),
+      .wait_message = session["wait_message"].toString(),
+      .state_since_ms = session["state_since_ms"].toLongLong()
+    });
+  }
+  return sessions;
+}
+
 Workspace_monitor::Workspace_monitor(QObject* parent)
   : QObject(parent)
   , _daemon_watcher(
@@ -46,13 +64,14 @@ Workspace_monitor::Workspace_monitor(QObject* parent)
   ))
     qWarning("Workspace_monitor: failed to connect desktopDataChanged signal");
 
-  // --- Daemon StatusChanged signal ---
+  // --- Daemon StatusesChanged signal ---
+  // One a{sa{sv}} batch per daemon frame; QDBusMessage slot for the nested map.
   if (!bus.connect(
     "org.workspace.StatusMonitor", "/StatusMonitor",
-    "org.workspace.StatusMonitor", "StatusChanged",
-    this, SLOT(on_status_changed(QString,QVariantMap))
+    "org.workspace.StatusMonitor", "StatusesChanged",
+    this, SLOT(on_statuses_changed(QDBusMessage))
   ))
-    qWarning("Workspace_monitor: failed to connect StatusChanged signal");
+    qWarning("Workspace_monitor: failed to connect StatusesChanged signal");
 
   // --- Watch for daemon appearance/disappearance ---
   connect(&_daemon_watcher, &QDBusServiceWatcher::serviceRegistered,
@@ -110,15 +129,23 @@ void Workspace_monitor::on_desktop_data_changed(const QDBusMessage& message) {
 
 // --- Daemon signal handler ---
 
-void Workspace_monitor::on_status_changed(const QString& workspace_name, const QVariantMap& status) {
-  _claude_statuses[workspace_name] = Claude_workspace_status{
-    .workspace_name = workspace_name,
-    .state = from_wire_string< Claude_state>(status["state"].toString()).value_or(Claude_state::NOT_RUNNING),
-    .tool_name = status["tool_name"].toString(),
-    .wait_reason = status["wait_reason"].toString(),
-    .wait_message = status["wait_message"].toString(),
-    .state_since_ms = status["state_since_ms"].toLongLong()
-  };
+void Workspace_monitor::on_statuses_changed(const QDBusMessage& message) {
+  if (message.arguments().isEmpty())
+    return;
+
+  auto statuses = qdbus_cast< QMap< QString, QVariantMap>>(message.arguments().at(0));
+  for (auto it = statuses.cbegin(); it != statuses.cend(); ++it) {
+    const auto& status = it.value();
+    _claude_statuses[it.key()] = Claude_workspace_status{
+      .workspace_name = it.key(),
+      .state = from_wire_string< Claude_state>(status["state"].toString()).value_or(Claude_state::NOT_RUNNING),
+      .tool_name = status["tool_name"].toString(),
+      .wait_reason = status["wait_reason"].toString(),
+      .wait_message = status["wait_message"].toString(),
+      .state_since_ms = status["state_since_ms"].toLongLong(),
+      .sessions = parse_sessions(status["sessions"])
+    };
+  }
   emit claudeStatusesChanged();
 }
 
@@ -191,7 +218,8 @@ void Workspace_monitor::on_statuses_fetched(QDBusPendingCallWatcher* watcher) {
       .tool_name = obj["tool_name"].toString(),
       .wait_reason = obj["wait_reason"].toString(),
       .wait_message = obj["wait_message"].toString(),
-      .state_since_ms = obj["state_since_ms"].toVariant().toLongLong()
+      .state_since_ms = obj["state_since_ms"].toVariant().toLongLong(),
+      .sessions = parse_sessions(obj["sessions"].toArray().toVariantList())
     };
   }
   _claude_statuses = statuses;
@@ -53,7 +53,7 @@ class Workspace_monitor : public QObject {
   void on_desktop_removed(const QDBusMessage& message);
   void on_desktop_data_changed(const QDBusMessage& message);
 
-  void on_status_changed(const QString& workspace_name, const QVariantMap& status);
+  void on_statuses_changed(const QDBusMessage& message);
 
   void on_daemon_registered();
   void on_daemon_unregistered();
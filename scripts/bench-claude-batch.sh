@@ -0,0 +1,39 @@
+#!/bin/bash
+# Measure ReportClaudeEvents throughput against a running daemon.
+# Sends batches of alternating working/post_tool events for one workspace
+# and prints events per second, including bus transfer and parsing.
+# Events carry no client time (0), so they apply in batch order; the same
+# batch is sent repeatedly and timestamped copies would be dropped as stale.
+# Usage: scripts/bench-claude-batch.sh [workspace] [batches] [batch_size]
+
+set -euo pipefail
+
+WORKSPACE="${1:-bench}"
+BATCHES="${2:-10}"
+BATCH_SIZE="${3:-1000}"
+
+batch="["
+for ((i = 0; i < BATCH_SIZE; i++)); do
+  [[ $i -gt 0 ]] && batch+=", "
+  if (( i % 2 == 0 )); then
+    batch+="('$WORKSPACE', 'working', 'Tool$((i % 7))', int64 0)"
+  else
+    batch+="('$WORKSPACE', 'post_tool', '', int64 0)"
+  fi
+done
+batch+="]"
+
+start=$(date +%s%N)
+for ((b = 0; b < BATCHES; b++)); do
+  gdbus call --session --dest org.workspace.StatusMonitor --object-path /StatusMonitor \
+    --method org.workspace.StatusMonitor.ReportClaudeEvents "$batch" >/dev/null
+done
+end=$(date +%s%N)
+
+gdbus call --session --dest org.workspace.StatusMonitor --object-path /StatusMonitor \
+  --method org.workspace.StatusMonitor.ReportClaudeEvent "$WORKSPACE" stop "" >/dev/null
+
+total=$(( BATCHES * BATCH_SIZE ))
+elapsed_us=$(( (end - start) / 1000 ))
+printf 'events: %d in %d batches, %d us\n' "$total" "$BATCHES" "$elapsed_us"
+printf 'throughput: %d events/s\n' $(( total * 1000000 / (elapsed_us > 0 ? elapsed_us : 1) ))
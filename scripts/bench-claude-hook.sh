@@ -0,0 +1,41 @@
+#!/bin/bash
+# Compare end-to-end wall time of the shell hook and the native hook client.
+# Needs a running daemon with a workspace whose project_dir contains CWD.
+# Usage: scripts/bench-claude-hook.sh [iterations] [cwd]
+
+set -euo pipefail
+
+REPO_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+ITERATIONS="${1:-200}"
+HOOK_CWD="${2:-$PWD}"
+SHELL_HOOK="$REPO_DIR/hooks/claude-status-hook.sh"
+NATIVE_HOOK="${NATIVE_HOOK:-$HOME/.local/bin/claude-status-hook}"
+
+if [[ ! -x "$NATIVE_HOOK" ]]; then
+  echo "Error: $NATIVE_HOOK not found (set NATIVE_HOOK)" >&2
+  exit 1
+fi
+
+# PostToolUse while WORKING: the most frequent event, and no visible state change.
+payload=$(printf '{"hook_event_name":"PostToolUse","cwd":"%s","session_id":"bench","tool_name":"Bash","tool_response":{"stdout":"%s"}}' \
+  "$HOOK_CWD" "$(head -c 32768 /dev/zero | tr '\0' 'x')")
+printf '{"hook_event_name":"PreToolUse","cwd":"%s","tool_name":"Bash"}' "$HOOK_CWD" | "$NATIVE_HOOK"
+
+run() {
+  local hook="$1"
+  local start end
+  start=$(date +%s%N)
+  for ((i = 0; i < ITERATIONS; i++)); do
+    printf '%s' "$payload" | "$hook"
+  done
+  end=$(date +%s%N)
+  echo $(( (end - start) / ITERATIONS / 1000 ))
+}
+
+shell_us=$(run "$SHELL_HOOK")
+native_us=$(run "$NATIVE_HOOK")
+printf '{"hook_event_name":"Stop","cwd":"%s"}' "$HOOK_CWD" | "$NATIVE_HOOK"
+
+printf 'iterations: %d, payload: %d bytes\n' "$ITERATIONS" "${#payload}"
+printf '  shell hook:  %6d us/event\n' "$shell_us"
+printf '  native hook: %6d us/event\n' "$native_us"